@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVASRC_H__
+#define __WAVASRC_H__
+
+#include <rtthread.h>
+
+#ifndef PKG_WP_ASRC_CHANNELS_MAX
+#define PKG_WP_ASRC_CHANNELS_MAX (8)
+#endif
+#ifndef PKG_WP_ASRC_PPM_MAX
+#define PKG_WP_ASRC_PPM_MAX (1000)
+#endif
+
+/**
+ * asynchronous rate adapter between two clock domains, the correction is steered
+ * by the fill level of the buffer between them
+ */
+struct wavasrc
+{
+    int channels;
+    rt_uint32_t samplerate;
+    rt_uint64_t step;                       /* input frames per output frame, Q32 */
+    rt_uint64_t phase;                      /* position after hist[1], Q32 */
+    rt_int16_t hist[4][PKG_WP_ASRC_CHANNELS_MAX];
+
+    /* drift estimation */
+    float level;                            /* smoothed fill level error in frames */
+    float integral;                         /* integral part of the correction */
+    float correction;                       /* ratio - 1 */
+};
+
+/**
+ * @brief             Initialize a rate adapter at the nominal ratio
+ *
+ * @param asrc        rate adapter
+ * @param samplerate  nominal samplerate of both sides
+ * @param channels    channels of the 16 bits interleaved stream
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavasrc_init(struct wavasrc *asrc, rt_uint32_t samplerate, int channels);
+
+/**
+ * @brief             Steer the ratio from the fill level of the buffer, called once per block
+ *
+ * @param asrc        rate adapter
+ * @param level       frames in the buffer between the two clock domains
+ * @param target      frames the buffer is kept at
+ * @param frames      frames processed since the last update
+ */
+void wavasrc_update(struct wavasrc *asrc, rt_size_t level, rt_size_t target, rt_size_t frames);
+
+/**
+ * @brief             Resample until the output is full or the input is used up
+ *
+ * @param asrc        rate adapter
+ * @param in          interleaved 16 bits input
+ * @param in_frames   frames of the input
+ * @param out         interleaved 16 bits output
+ * @param out_frames  room of the output in frames
+ * @param consumed    the pointer to store the input frames used
+ *
+ * @return            output frames
+ */
+rt_size_t wavasrc_process(struct wavasrc *asrc, const rt_int16_t *in, rt_size_t in_frames,
+                          rt_int16_t *out, rt_size_t out_frames, rt_size_t *consumed);
+
+/**
+ * @brief             Get the current correction
+ *
+ * @param asrc        rate adapter
+ *
+ * @return            correction in ppm, > 0 when the input clock runs faster
+ */
+rt_int32_t wavasrc_ppm_get(const struct wavasrc *asrc);
+
+#endif
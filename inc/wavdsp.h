@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVDSP_H__
+#define __WAVDSP_H__
+
+#include <rtthread.h>
+
+#ifndef PKG_WP_EQ_SECTIONS_MAX
+#define PKG_WP_EQ_SECTIONS_MAX (8)
+#endif
+
+/* samples between stages are 16 bits scale in 32 bits, with 24 dB of headroom */
+#define WAVDSP_SAMPLE_LIMIT  (1L << 19)
+
+struct wavdsp_stage;
+
+struct wavdsp_stage_ops
+{
+    /* called in the player thread before the first block of a stream */
+    rt_err_t (*prepare)(struct wavdsp_stage *stage, rt_uint32_t samplerate, int channels);
+    /* process interleaved frames in place, samples stay below WAVDSP_SAMPLE_LIMIT */
+    void (*process)(struct wavdsp_stage *stage, rt_int32_t *data, rt_size_t frames);
+    /* optional, forget the signal history when the stage leaves bypass */
+    void (*reset)(struct wavdsp_stage *stage);
+    /* release the stage object */
+    void (*destroy)(struct wavdsp_stage *stage);
+};
+
+/**
+ * processing stage of the playback chain, runs before the sound device
+ */
+struct wavdsp_stage
+{
+    const struct wavdsp_stage_ops *ops;
+    const char *name;
+    struct wavdsp_stage *next;
+    rt_bool_t bypass;
+
+    /* format the stage is prepared for, maintained by the chain */
+    rt_uint32_t samplerate;
+    rt_uint16_t channels;
+    rt_bool_t ready;
+    rt_bool_t idle;                         /* skipped by bypass since the last block */
+};
+
+enum WAVDSP_EQ_FORMAT
+{
+    WAVDSP_EQ_Q31 = 0,                      /* direct form I, 64 bits accumulator */
+    WAVDSP_EQ_F32 = 1,                      /* transposed direct form II */
+};
+
+enum WAVDSP_BAND_TYPE
+{
+    WAVDSP_BAND_OFF       = 0,
+    WAVDSP_BAND_PEAK      = 1,
+    WAVDSP_BAND_LOWSHELF  = 2,
+    WAVDSP_BAND_HIGHSHELF = 3,
+    WAVDSP_BAND_LOWPASS   = 4,
+    WAVDSP_BAND_HIGHPASS  = 5,
+};
+
+/**
+ * equalizer band, designed for the samplerate of each stream
+ */
+struct wavdsp_band
+{
+    int type;
+    float freq;                             /* center or corner frequency in Hz */
+    float q;                                /* quality factor, shelf slope for shelves */
+    float gain;                             /* dB, ignored by pass filters */
+};
+
+/**
+ * normalized biquad coefficients, y = b0x + b1x1 + b2x2 - a1y1 - a2y2
+ */
+struct wavdsp_biquad
+{
+    float b0, b1, b2;
+    float a1, a2;
+};
+
+/**
+ * limiter and compressor parameters
+ */
+struct wavdsp_dynamics
+{
+    float ceiling;                          /* dBFS the output peaks are limited to, <= 0 */
+    float lookahead;                        /* ms, takes effect from the next stream */
+    float release;                          /* ms of the limiter to recover */
+    rt_uint8_t compressor;                  /* enable the compressor in front of the limiter */
+    float threshold;                        /* dBFS the compressor starts at */
+    float ratio;                            /* compression ratio above threshold, >= 1 */
+    float attack;                           /* ms of the compressor */
+    float comp_release;                     /* ms of the compressor */
+    float makeup;                           /* dB of gain after compression */
+};
+
+/**
+ * @brief             Run the stages of a chain on a block
+ *
+ * @param chain       first stage
+ * @param data        interleaved 16 bits frames, processed in place and saturated at the end
+ * @param work        working buffer of frames * channels samples
+ * @param frames      number of frames
+ * @param samplerate  samplerate of the stream
+ * @param channels    channels of the stream
+ */
+void wavdsp_chain_process(struct wavdsp_stage *chain, rt_int16_t *data, rt_int32_t *work, rt_size_t frames,
+                          rt_uint32_t samplerate, int channels);
+
+/**
+ * @brief             Force the stages of a chain to be prepared again
+ *
+ * @param chain       first stage
+ */
+void wavdsp_chain_reset(struct wavdsp_stage *chain);
+
+/**
+ * @brief             Delete a stage that isn't in a chain
+ *
+ * @param stage       stage object
+ */
+void wavdsp_stage_delete(struct wavdsp_stage *stage);
+
+/**
+ * @brief             Create a cascade of biquad sections
+ *
+ * @param sections    number of sections, 1 ~ PKG_WP_EQ_SECTIONS_MAX, all bypassed at first
+ * @param format      WAVDSP_EQ_Q31 or WAVDSP_EQ_F32
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Stage object
+ */
+struct wavdsp_stage *wavdsp_eq_create(int sections, int format);
+
+/**
+ * @brief             Set a section from a band description, applied at the next block
+ *
+ * @param stage       equalizer stage
+ * @param index       section index
+ * @param band        band description
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavdsp_eq_band_set(struct wavdsp_stage *stage, int index, const struct wavdsp_band *band);
+
+/**
+ * @brief             Set a section from fixed coefficients, applied at the next block
+ *
+ * @param stage       equalizer stage
+ * @param index       section index
+ * @param coeff       coefficients designed for the samplerate of the streams
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavdsp_eq_coeff_set(struct wavdsp_stage *stage, int index, const struct wavdsp_biquad *coeff);
+
+/**
+ * @brief             Compute biquad coefficients of a band
+ *
+ * @param coeff       the pointer to store the coefficients
+ * @param band        band description
+ * @param samplerate  samplerate in Hz
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavdsp_biquad_design(struct wavdsp_biquad *coeff, const struct wavdsp_band *band, rt_uint32_t samplerate);
+
+/**
+ * @brief             Create a look-ahead peak limiter with an optional compressor
+ *
+ * @param params      dynamics parameters, RT_NULL for a -1 dBFS limiter
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Stage object
+ */
+struct wavdsp_stage *wavdsp_limiter_create(const struct wavdsp_dynamics *params);
+
+/**
+ * @brief             Change the limiter parameters, applied at the next block
+ *
+ * @param stage       limiter stage
+ * @param params      dynamics parameters
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavdsp_limiter_set(struct wavdsp_stage *stage, const struct wavdsp_dynamics *params);
+
+/**
+ * @brief             Get the gain reduction of the limiter and compressor
+ *
+ * @param stage       limiter stage
+ * @param reduction   the pointer to store the current reduction in dB
+ * @param reduction_max the pointer to store the largest reduction since the last call
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavdsp_limiter_reduction_get(struct wavdsp_stage *stage, float *reduction, float *reduction_max);
+
+#endif
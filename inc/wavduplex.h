@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVDUPLEX_H__
+#define __WAVDUPLEX_H__
+
+#include <rtthread.h>
+
+/**
+ * @brief             Block callback of a duplex session, runs in the duplex thread
+ *
+ * @param play        played frames, interleaved
+ * @param record      captured frames, interleaved
+ * @param frames      frames in both blocks
+ * @param timestamp   device frame of the first frame in both blocks
+ * @param user_data   user data of the session
+ */
+typedef void (*wavduplex_block_t)(const rt_int16_t *play, const rt_int16_t *record,
+                                  rt_size_t frames, rt_uint64_t timestamp, void *user_data);
+
+struct wavduplex_info
+{
+    char *play_uri;                         /* wav file played as reference, RT_NULL plays silence */
+    char *record_uri;                       /* wav file to record, RT_NULL to skip writing */
+    rt_uint32_t samplerate;                 /* must match the play file */
+    rt_uint16_t channels;                   /* record channels */
+    rt_bool_t reference;                    /* append the played reference as an extra record channel */
+    wavduplex_block_t callback;
+    void *user_data;
+};
+
+/**
+ * @brief             Start playing and recording on a common frame clock
+ *
+ * @param info        session informations
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavduplex_start(struct wavduplex_info *info);
+
+/**
+ * @brief             Stop the duplex session
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavduplex_stop(void);
+
+/**
+ * @brief             Get duplex session status
+ *
+ * @return
+ *      - RT_TRUE     actived
+ *      - RT_FALSE    non-actived
+ */
+rt_bool_t wavduplex_is_actived(void);
+
+/**
+ * @brief             Measure the round trip latency by playing an impulse and finding it in the capture
+ *
+ * @param samplerate  samplerate used for the measurement
+ * @param latency     the pointer to store the latency in frames
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - -RT_ETIMEOUT impulse not found within one second
+ *      - < 0         Failed
+ */
+rt_err_t wavduplex_latency_measure(rt_uint32_t samplerate, rt_uint32_t *latency);
+
+#endif
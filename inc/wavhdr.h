@@ -11,14 +11,28 @@
 #define __WAVHDR_H__
 
 #include <stdio.h>
+#include <rtthread.h>
+#include <wavio.h>
+
+#define WAVE_FORMAT_PCM        (0x0001)
+#define WAVE_FORMAT_IEEE_FLOAT (0x0003)
+#define WAVE_FORMAT_EXTENSIBLE (0xFFFE)
+
+#define WAVHDR_SIZE_RF64       (0xFFFFFFFFUL)   /* 32 bits size of RF64 files, the ds64 chunk holds it */
 
 struct wav_header
 {
-    char  riff_id[4];                       /* "RIFF" */
-    int   riff_datasize;                    /* RIFF chunk data size,exclude riff_id[4] and riff_datasize,total - 8 */
+    char  riff_id[4];                       /* "RIFF", or "RF64" when the sizes need 64 bits */
+    unsigned int riff_datasize;             /* RIFF chunk data size,exclude riff_id[4] and riff_datasize,total - 8 */
 
     char  riff_type[4];                     /* "WAVE" */
 
+    /* RF64, "ds64" chunk right after "WAVE", "JUNK" keeps its room in a RIFF file, 0 for none */
+    char  ds64_id[4];
+    rt_uint64_t ds64_riff_size;             /* riff_datasize of RF64 files */
+    rt_uint64_t ds64_data_size;             /* data_datasize of RF64 files */
+    rt_uint64_t ds64_sample_count;          /* frames of the data chunk */
+
     char  fmt_id[4];                        /* "fmt " */
     int   fmt_datasize;                     /* fmt chunk data size,16 for pcm */
     short fmt_compression_code;             /* 1 for PCM */
@@ -28,8 +42,16 @@ struct wav_header
     short fmt_block_align;                  /* number bytes per sample, bit_per_sample * channels / 8 */
     short fmt_bit_per_sample;               /* bits of each sample(8,16,32). */
 
+    /* WAVE_FORMAT_EXTENSIBLE only, fmt_datasize is 40 */
+    short fmt_ext_size;                     /* 22 */
+    short fmt_valid_bits;                   /* bits used in each sample, the most significant ones */
+    int   fmt_channel_mask;                 /* speaker of each channel, 0 for none */
+    short fmt_sub_format;                   /* WAVE_FORMAT_PCM or WAVE_FORMAT_IEEE_FLOAT */
+
     char  data_id[4];                       /* "data" */
-    int   data_datasize;                    /* data chunk size,pcm_size - 44 */
+    unsigned int data_datasize;             /* data chunk size,pcm_size - 44, WAVHDR_SIZE_RF64 in RF64 files */
+
+    rt_uint64_t datasize;                   /* data chunk size of RIFF and RF64 files, filled by the reader */
 };
 
 /**
@@ -47,7 +69,60 @@ struct wav_header
 int wavheader_init(struct wav_header *header, int sample_rate, int channels, int datasize);
 
 /**
- * @brief             Read wavfile head information from file stream
+ * @brief             Initialize wavfile header of any sample format, WAVE_FORMAT_EXTENSIBLE
+ *                    is used for more than 16 bits or 2 channels
+ *
+ * @param header      the pointer for wavfile header
+ * @param sample_rate wavfile samplerate
+ * @param channels    wavfile channels
+ * @param samplebits  bits of each sample in the file, 8, 16, 24 or 32
+ * @param validbits   bits used in each sample, <= samplebits
+ * @param format      WAVE_FORMAT_PCM or WAVE_FORMAT_IEEE_FLOAT
+ * @param datasize    wavfile total data size
+ *
+ * @return
+ *      - 0  Success
+ *      - -1 Error
+ */
+int wavheader_init_format(struct wav_header *header, int sample_rate, int channels,
+                          int samplebits, int validbits, int format, int datasize);
+
+/**
+ * @brief             Keep room for a ds64 chunk after "WAVE" with a "JUNK" chunk, so that
+ *                    wavheader_datasize_set() can turn the header into RF64 in place once the
+ *                    data grows past 4 GB. Call it after wavheader_init_format(), the header
+ *                    grows by 36 bytes.
+ *
+ * @param header      the pointer for wavfile header
+ */
+void wavheader_ds64_reserve(struct wav_header *header);
+
+/**
+ * @brief             Set the data size, the header is written as RF64 when the RIFF sizes don't
+ *                    fit in 32 bits and as RIFF otherwise
+ *
+ * @param header      the pointer for wavfile header
+ * @param datasize    bytes of pcm data
+ *
+ * @return
+ *      - 0  Success
+ *      - -1 the size needs RF64 and no room was reserved, the 32 bits sizes are saturated
+ */
+int wavheader_datasize_set(struct wav_header *header, rt_uint64_t datasize);
+
+/**
+ * @brief             Get the bytes taken by a header in the file
+ *
+ * @param header      the pointer for wavfile header
+ *
+ * @return            header size, the offset of the pcm data written after it
+ */
+int wavheader_size(struct wav_header *header);
+
+/**
+ * @brief             Read wavfile head information from file stream, unknown chunks are
+ *                    skipped and the stream is left at the start of the pcm data. RF64 files
+ *                    are read too, the 64 bits sizes come from their ds64 chunk.
  *
  * @param header      the pointer for wavfile header
  * @param fp          file stream
@@ -70,6 +145,30 @@ int wavheader_read(struct wav_header *header, FILE *fp);
  */
 int wavheader_write(struct wav_header *header, FILE *fp);
 
+/**
+ * @brief             Read wavfile head information from a file of any backend, see wavheader_read()
+ *
+ * @param header      the pointer for wavfile header
+ * @param io          opened file
+ *
+ * @return
+ *      - 0  Success
+ *      - -1 Error
+ */
+int wavheader_io_read(struct wav_header *header, struct wavio *io);
+
+/**
+ * @brief             Write wavfile head information to a file of any backend
+ *
+ * @param header      the pointer for wavfile header
+ * @param io          opened file
+ *
+ * @return
+ *      - 0  Success
+ *      - -1 Error
+ */
+int wavheader_io_write(struct wav_header *header, struct wavio *io);
+
 /**
  * @brief             Print wavfile header information
  *
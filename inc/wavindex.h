@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVINDEX_H__
+#define __WAVINDEX_H__
+
+#include <rtthread.h>
+#include <wavhdr.h>
+
+#ifndef PKG_WP_INDEX_NAME_MAX
+#define PKG_WP_INDEX_NAME_MAX (32)
+#endif
+
+/**
+ * metadata of one wav file, stored as is in the index file
+ */
+struct wavindex_entry
+{
+    char name[PKG_WP_INDEX_NAME_MAX];       /* file name in the directory */
+    rt_uint32_t mtime;                      /* modification time the entry was taken at */
+    rt_uint64_t file_size;                  /* file size the entry was taken at */
+    rt_uint32_t data_offset;                /* offset of the pcm in the file */
+    struct wav_header header;               /* header as wavheader_read() parsed it */
+};
+
+typedef struct wavindex *wavindex_t;
+
+/**
+ * @brief             Scan a directory for wav files, files unchanged since the index file
+ *                    was written are taken from it, the index file is rewritten on change
+ *
+ * @param dir         directory to scan
+ * @param index_path  index file, RT_NULL for "<dir>/.wavindex"
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Index handle
+ */
+wavindex_t wavindex_open(const char *dir, const char *index_path);
+
+/**
+ * @brief             Release an index
+ *
+ * @param index       index handle
+ */
+void wavindex_close(wavindex_t index);
+
+/**
+ * @brief             Get the number of wav files in the index
+ *
+ * @param index       index handle
+ *
+ * @return            number of entries
+ */
+int wavindex_count(wavindex_t index);
+
+/**
+ * @brief             Get an entry by position, entries are sorted by name
+ *
+ * @param index       index handle
+ * @param position    0 ~ wavindex_count() - 1
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Entry, valid until the index is closed
+ */
+const struct wavindex_entry *wavindex_get(wavindex_t index, int position);
+
+/**
+ * @brief             Find a file by name without touching the file
+ *
+ * @param index       index handle
+ * @param name        file name in the directory
+ * @param header      the pointer to store the parsed header, RT_NULL if not needed
+ *
+ * @return
+ *      - RT_NULL Not found
+ *      - others  Entry, valid until the index is closed
+ */
+const struct wavindex_entry *wavindex_lookup(wavindex_t index, const char *name, struct wav_header *header);
+
+/**
+ * @brief             Get the play time of an entry
+ *
+ * @param entry       index entry
+ *
+ * @return            duration in ms
+ */
+rt_uint32_t wavindex_duration(const struct wavindex_entry *entry);
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVIO_H__
+#define __WAVIO_H__
+
+#include <rtthread.h>
+#include <stdio.h>
+
+#ifndef PKG_WP_IO_BACKEND
+#define PKG_WP_IO_BACKEND (WAVIO_BACKEND_STDIO)
+#endif
+#ifndef PKG_WP_IO_SECTOR_SIZE
+#define PKG_WP_IO_SECTOR_SIZE (512)
+#endif
+
+/**
+ * file access of the wav streams
+ */
+enum WAVIO_BACKEND
+{
+    WAVIO_BACKEND_STDIO  = 0,               /* fopen/fread, buffered by the C library */
+    WAVIO_BACKEND_FD     = 1,               /* open/read, straight to the file system cache */
+    WAVIO_BACKEND_DIRECT = 2,               /* open/read of whole sectors at sector aligned offsets */
+    WAVIO_BACKEND_MMAP   = 3,               /* read only mapping, reads point into it without a copy */
+    WAVIO_BACKEND_MAX,
+};
+
+enum WAVIO_MODE
+{
+    WAVIO_MODE_READ  = 0,                   /* read an existing file */
+    WAVIO_MODE_WRITE = 1,                   /* create or truncate a file, read and write */
+};
+
+struct wavio;
+
+struct wavio_ops
+{
+    rt_err_t (*open)(struct wavio *io, const char *path, int mode);
+    /* fill buffer, or point data to memory of the backend, returns the bytes at data */
+    rt_ssize_t (*read)(struct wavio *io, void *buffer, rt_size_t size, void **data);
+    rt_ssize_t (*write)(struct wavio *io, const void *buffer, rt_size_t size);
+    /* returns the new offset from the start of the file, < 0 on failure */
+    rt_off_t (*seek)(struct wavio *io, rt_off_t offset, int whence);
+    void (*close)(struct wavio *io);
+};
+
+/**
+ * opened file of any backend, embedded in its owner
+ */
+struct wavio
+{
+    const struct wavio_ops *ops;
+    int backend;
+
+    FILE *fp;                               /* stdio */
+    rt_bool_t attached;                     /* stdio, fp is closed by its owner */
+    int fd;                                 /* fd, direct and mmap */
+    rt_off_t pos;                           /* offset of the next read or write */
+    rt_off_t size;                          /* mmap, bytes mapped */
+    rt_uint8_t *map;                        /* mmap, start of the mapping */
+
+    /* direct, partial sectors at both ends of a read go through one sector */
+    rt_uint8_t *sector;
+    rt_off_t sector_pos;                    /* offset of the sector held, -1 for none */
+    rt_size_t sector_len;
+    rt_off_t fd_pos;                        /* offset of the file descriptor */
+};
+
+/**
+ * @brief             Open a file with a backend
+ *
+ * @param io          the pointer for the file object
+ * @param path        file path
+ * @param mode        WAVIO_MODE_READ or WAVIO_MODE_WRITE, mmap is read only
+ * @param backend     WAVIO_BACKEND_xxx
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavio_open(struct wavio *io, const char *path, int mode, int backend);
+
+/**
+ * @brief             Use a file stream opened by the caller, wavio_close() doesn't close it
+ *
+ * @param io          the pointer for the file object
+ * @param fp          file stream
+ */
+void wavio_attach(struct wavio *io, FILE *fp);
+
+/**
+ * @brief             Read bytes into a buffer
+ *
+ * @return            bytes read, 0 at the end of file, < 0 on failure
+ */
+rt_ssize_t wavio_read(struct wavio *io, void *buffer, rt_size_t size);
+
+/**
+ * @brief             Read bytes without copying them when the backend can, mmap points data
+ *                    into the mapping and the other backends fill buffer
+ *
+ * @param io          the pointer for the file object
+ * @param buffer      buffer of size bytes, used when the backend can't avoid the copy
+ * @param size        bytes to read
+ * @param data        the pointer to store the start of the bytes read
+ *
+ * @return            bytes at data, 0 at the end of file, < 0 on failure
+ */
+rt_ssize_t wavio_read_ref(struct wavio *io, void *buffer, rt_size_t size, void **data);
+
+/**
+ * @brief             Write bytes
+ *
+ * @return            bytes written, < 0 on failure
+ */
+rt_ssize_t wavio_write(struct wavio *io, const void *buffer, rt_size_t size);
+
+/**
+ * @brief             Move the file offset, whence is SEEK_SET, SEEK_CUR or SEEK_END
+ *
+ * @return            new offset from the start of the file, < 0 on failure
+ */
+rt_off_t wavio_seek(struct wavio *io, rt_off_t offset, int whence);
+
+/**
+ * @brief             Get the file offset
+ *
+ * @return            offset from the start of the file, < 0 on failure
+ */
+rt_off_t wavio_tell(struct wavio *io);
+
+/**
+ * @brief             Close a file, does nothing when it isn't opened
+ *
+ * @param io          the pointer for the file object
+ */
+void wavio_close(struct wavio *io);
+
+/**
+ * @brief             Get the name of a backend
+ *
+ * @param backend     WAVIO_BACKEND_xxx
+ *
+ * @return            backend name, "unknown" when out of range
+ */
+const char *wavio_backend_name(int backend);
+
+/**
+ * @brief             Find a backend by name
+ *
+ * @param name        "stdio", "fd", "direct" or "mmap"
+ *
+ * @return            WAVIO_BACKEND_xxx, < 0 when there is no such backend
+ */
+int wavio_backend_find(const char *name);
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVMETER_H__
+#define __WAVMETER_H__
+
+#include <rtthread.h>
+
+#ifndef PKG_WP_METER_CHANNELS_MAX
+#define PKG_WP_METER_CHANNELS_MAX (8)
+#endif
+
+/**
+ * levels of the last metered block, full scale is 32767
+ */
+struct wavmeter_level
+{
+    rt_uint32_t blocks;                     /* blocks metered since the stream started */
+    rt_uint16_t channels;
+    rt_uint16_t peak[PKG_WP_METER_CHANNELS_MAX];
+    rt_uint16_t rms[PKG_WP_METER_CHANNELS_MAX];
+};
+
+/**
+ * level snapshot written by one audio thread and read by any thread without locking
+ */
+struct wavmeter
+{
+    volatile rt_uint32_t sequence;          /* odd while the writer updates level */
+    struct wavmeter_level level;
+};
+
+/**
+ * @brief             Clear the levels, called by the writer thread
+ *
+ * @param meter       meter object
+ * @param channels    channels of the new stream
+ */
+void wavmeter_reset(struct wavmeter *meter, int channels);
+
+/**
+ * @brief             Meter a block of interleaved 16 bits pcm, called by the writer thread
+ *
+ * @param meter       meter object
+ * @param data        interleaved samples
+ * @param size        bytes of data
+ */
+void wavmeter_update(struct wavmeter *meter, const void *data, rt_size_t size);
+
+/**
+ * @brief             Take a consistent copy of the levels from any thread
+ *
+ * @param meter       meter object
+ * @param level       the pointer to store the levels
+ */
+void wavmeter_read(const struct wavmeter *meter, struct wavmeter_level *level);
+
+#endif
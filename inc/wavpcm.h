@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVPCM_H__
+#define __WAVPCM_H__
+
+#include <rtthread.h>
+
+#ifndef PKG_WP_DITHER_CHANNELS_MAX
+#define PKG_WP_DITHER_CHANNELS_MAX (8)
+#endif
+
+/* specialized requantization kernels compiled in, WAVPCM_KERNEL_xxx formats and channel counts */
+#define WAVPCM_KERNEL_S24    (0x01)         /* 24 bits packed */
+#define WAVPCM_KERNEL_S32    (0x02)         /* 32 bits integer */
+#define WAVPCM_KERNEL_F32    (0x04)         /* 32 bits float */
+#define WAVPCM_KERNEL_MONO   (0x10)
+#define WAVPCM_KERNEL_STEREO (0x20)
+
+#ifndef PKG_WP_PCM_KERNELS
+#define PKG_WP_PCM_KERNELS (WAVPCM_KERNEL_S24 | WAVPCM_KERNEL_S32 | WAVPCM_KERNEL_F32 | \
+                            WAVPCM_KERNEL_MONO | WAVPCM_KERNEL_STEREO)
+#endif
+
+enum WAVPCM_DITHER
+{
+    WAVPCM_DITHER_NONE   = 0,               /* round to nearest */
+    WAVPCM_DITHER_TPDF   = 1,               /* triangular dither of +-1 LSB */
+    WAVPCM_DITHER_SHAPED = 2,               /* TPDF with first order noise shaping */
+};
+
+/**
+ * requantizer state of a stream, kept across blocks
+ */
+struct wavpcm_dither
+{
+    int mode;
+    rt_uint32_t seed[PKG_WP_DITHER_CHANNELS_MAX];   /* xorshift state of each channel */
+    rt_int32_t error[PKG_WP_DITHER_CHANNELS_MAX];   /* last quantization error, 32 bits scale */
+};
+
+/**
+ * requantization of one source format, channels and dither mode, see wavpcm_requantize_select()
+ */
+typedef void (*wavpcm_requantize_t)(struct wavpcm_dither *dither, const void *in, rt_int16_t *out,
+                                    int channels, rt_size_t frames);
+
+/**
+ * @brief             Split interleaved 16 bits frames into one buffer per channel
+ *
+ * @param in          interleaved samples
+ * @param out         output buffers, out[i] receives the samples of channel map[i]
+ * @param map         channel index of each output
+ * @param outputs     number of outputs
+ * @param channels    channels of the interleaved input
+ * @param frames      number of frames in the input
+ *
+ * @return
+ *      - None
+ */
+void wavpcm_deinterleave16(const rt_int16_t *in, void *const *out, const rt_uint8_t *map,
+                           int outputs, int channels, rt_size_t frames);
+
+/**
+ * @brief             Split interleaved 32 bits frames into one buffer per channel
+ *
+ * @param in          interleaved samples
+ * @param out         output buffers, out[i] receives the samples of channel map[i]
+ * @param map         channel index of each output
+ * @param outputs     number of outputs
+ * @param channels    channels of the interleaved input
+ * @param frames      number of frames in the input
+ *
+ * @return
+ *      - None
+ */
+void wavpcm_deinterleave32(const rt_int32_t *in, void *const *out, const rt_uint8_t *map,
+                           int outputs, int channels, rt_size_t frames);
+
+/**
+ * @brief             Pack the upper 24 bits of 32 bits samples into 3 bytes, in place is allowed
+ *
+ * @param in          32 bits samples, 4 bytes aligned
+ * @param out         packed samples, in or 4 bytes aligned
+ * @param samples     number of samples
+ *
+ * @return
+ *      - None
+ */
+void wavpcm_pack24(const rt_int32_t *in, rt_uint8_t *out, rt_size_t samples);
+
+/**
+ * @brief             Convert 32 bits samples to IEEE float in [-1, 1), in place is allowed
+ *
+ * @param in          32 bits samples
+ * @param out         float samples
+ * @param samples     number of samples
+ *
+ * @return
+ *      - None
+ */
+void wavpcm_float32(const rt_int32_t *in, float *out, rt_size_t samples);
+
+/**
+ * @brief             Reset the requantizer for a new stream
+ *
+ * @param dither      requantizer state
+ * @param mode        WAVPCM_DITHER_xxx
+ *
+ * @return
+ *      - None
+ */
+void wavpcm_dither_init(struct wavpcm_dither *dither, int mode);
+
+/**
+ * @brief             Convert wide samples to 16 bits with dither, in place is allowed
+ *
+ * @param dither      requantizer state
+ * @param in          interleaved 24 bits packed, 32 bits integer or float samples
+ * @param samplebits  24 or 32
+ * @param is_float    in holds IEEE float samples, samplebits is 32
+ * @param out         interleaved 16 bits samples
+ * @param channels    channels of the stream
+ * @param frames      number of frames
+ *
+ * @return
+ *      - None
+ */
+void wavpcm_requantize16(struct wavpcm_dither *dither, const void *in, int samplebits, rt_bool_t is_float,
+                         rt_int16_t *out, int channels, rt_size_t frames);
+
+/**
+ * @brief             Get the requantization for a stream once when it is opened. Mono and stereo
+ *                    streams of the PKG_WP_PCM_KERNELS formats get a kernel with the channels and
+ *                    the dither mode fixed at compile time, others a kernel of the source format.
+ *
+ * @param samplebits  24 or 32
+ * @param is_float    IEEE float samples, samplebits is 32
+ * @param channels    channels of the stream, up to PKG_WP_DITHER_CHANNELS_MAX
+ * @param mode        WAVPCM_DITHER_xxx, the mode of the dither state passed to the kernel
+ *
+ * @return            requantization kernel, RT_NULL when the format isn't supported
+ */
+wavpcm_requantize_t wavpcm_requantize_select(int samplebits, rt_bool_t is_float, int channels, int mode);
+
+#endif
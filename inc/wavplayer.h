@@ -10,6 +10,13 @@
 #ifndef __WAVPLAYER_H__
 #define __WAVPLAYER_H__
 
+#include <rtthread.h>
+#include <wavsource.h>
+#include <wavmeter.h>
+#ifdef PKG_WP_USING_DSP
+#include <wavdsp.h>
+#endif
+
 /**
  * wav player status
  */
@@ -20,6 +27,86 @@ enum PLAYER_STATE
     PLAYER_STATE_PAUSED  = 2,
 };
 
+/**
+ * wav player instance handle
+ */
+typedef struct wavplayer *wavplayer_t;
+
+/**
+ * wav player notifications, also used as event set flags
+ */
+enum PLAYER_NOTIFY
+{
+    PLAYER_NOTIFY_STARTED = 0x01,           /* stream opened and playing */
+    PLAYER_NOTIFY_STOPPED = 0x02,           /* stream stopped by request */
+    PLAYER_NOTIFY_PAUSED  = 0x04,
+    PLAYER_NOTIFY_RESUMED = 0x08,
+    PLAYER_NOTIFY_EOS     = 0x10,           /* stream played to the end */
+    PLAYER_NOTIFY_ERROR   = 0x20,           /* stream failed to open */
+};
+
+/**
+ * wav player notification callback, runs in the player thread.
+ * It must not call the blocking control API, the _async variants are allowed.
+ */
+typedef void (*wavplayer_callback_t)(int event, int result, void *user_data);
+
+/**
+ * storage power hook of burst mode, runs in the file reader thread.
+ * active is RT_TRUE before a burst reads the storage and RT_FALSE once it is done.
+ */
+typedef void (*wavplayer_storage_hook_t)(rt_bool_t active, void *user_data);
+
+/**
+ * activity of the current or last stream, for comparing the power cost of buffer settings
+ */
+struct wavplayer_power_stat
+{
+    rt_uint32_t elapsed;                    /* ms since the stream started */
+    rt_uint32_t io_wakeups;                 /* times the file reader woke up to read */
+    rt_uint32_t write_wakeups;              /* blocks written to the sound device */
+    rt_uint32_t storage_active;             /* ms the storage had to stay powered */
+};
+
+/**
+ * load of the player threads on the current or last stream, in per mille of one core
+ */
+struct wavplayer_cpu_stat
+{
+    rt_uint32_t elapsed;                    /* ms since the stream started */
+    rt_uint16_t io;                         /* file reader thread, reads from the source */
+    rt_uint16_t dsp;                        /* processing thread, 0 without the pipeline */
+    rt_uint16_t sink;                       /* player thread, processing without the pipeline, writes excluded */
+};
+
+/**
+ * wav player runtime configuration
+ */
+struct wavplayer_config
+{
+    rt_uint32_t buffer_size;                /* bytes of each audio block */
+    rt_uint16_t buffer_count;               /* blocks queued between file reader and sound device */
+    rt_uint16_t buffer_count_max;           /* upper bound of buffer_count in adaptive mode */
+    rt_uint32_t ram_limit;                  /* upper bound of the block memory in bytes, at least buffer_size * buffer_count */
+    rt_uint32_t stable_time;                /* ms without underrun before adaptive mode shrinks */
+    rt_uint32_t io_stack_size;              /* stack size of the file reader thread */
+    rt_uint8_t  thread_priority;            /* priority of the player thread */
+    rt_uint8_t  io_thread_priority;         /* priority of the file reader thread */
+    rt_uint8_t  adaptive;                   /* grow buffer_count on underrun, shrink when stable */
+    rt_uint32_t keepalive_time;             /* ms the device stays open after stop, 0 closes at once */
+    rt_uint8_t  meter;                      /* compute peak and rms of each played block */
+    rt_uint8_t  samplebits;                 /* 16 requantizes 24 and 32 bits streams, 0 plays them as is */
+    rt_uint8_t  dither;                     /* WAVPCM_DITHER_xxx of the requantization, see wavpcm.h */
+    rt_uint32_t burst_size;                 /* bytes read in one burst, 0 reads block by block */
+    rt_uint16_t burst_low;                  /* filled blocks left when the next burst starts */
+    rt_uint8_t  io_backend;                 /* WAVIO_BACKEND_xxx the files played by uri are read with */
+    rt_uint8_t  pipeline;                   /* process blocks in their own thread, from the next stream */
+    rt_uint8_t  io_cpu;                     /* core of the file reader thread, RT_CPUS_NR or above leaves it free */
+    rt_uint8_t  dsp_cpu;                    /* core of the processing thread of the pipeline */
+    rt_uint8_t  sink_cpu;                   /* core of the player thread writing the sound device */
+    rt_uint16_t crossfade;                  /* ms of the crossfade between tracks, 0 cuts, from the next stream */
+};
+
 /**
  * @brief             Play wav music
  *
@@ -31,6 +118,18 @@ enum PLAYER_STATE
  */
 int wavplayer_play(char *uri);
 
+/**
+ * @brief             Play wav music after the current one, crossfaded into its end when the
+ *                    crossfade is enabled, otherwise or when nothing plays it starts at once
+ *
+ * @param uri         the pointer for file path
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_play_next(char *uri);
+
 /**
  * @brief             Stop music
  *
@@ -58,6 +157,89 @@ int wavplayer_pause(void);
  */
 int wavplayer_resume(void);
 
+/**
+ * @brief             Play a stream source, see wavsource.h
+ *
+ * @param source      stream source, stays owned by the caller and must outlive the stream
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_play_source(struct wavsource *source);
+
+/**
+ * @brief             Play a stream source without waiting for the player thread
+ *
+ * @param source      stream source, stays owned by the caller and must outlive the stream
+ *
+ * @return
+ *      - 0      Request posted, the result is reported by notification
+ *      - others Failed
+ */
+int wavplayer_play_source_async(struct wavsource *source);
+
+/**
+ * @brief             Play wav music without waiting for the player thread
+ *
+ * @param uri         the pointer for file path
+ *
+ * @return
+ *      - 0      Request posted, the result is reported by notification
+ *      - others Failed
+ */
+int wavplayer_play_async(char *uri);
+
+/**
+ * @brief             Stop music without waiting for the player thread
+ *
+ * @return
+ *      - 0      Request posted
+ *      - others Failed
+ */
+int wavplayer_stop_async(void);
+
+/**
+ * @brief             Pause music without waiting for the player thread
+ *
+ * @return
+ *      - 0      Request posted
+ *      - others Failed
+ */
+int wavplayer_pause_async(void);
+
+/**
+ * @brief             Resume music without waiting for the player thread
+ *
+ * @return
+ *      - 0      Request posted
+ *      - others Failed
+ */
+int wavplayer_resume_async(void);
+
+/**
+ * @brief             Register notification callback
+ *
+ * @param callback    callback function, RT_NULL to unregister
+ * @param user_data   user data passed to the callback
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_callback_set(wavplayer_callback_t callback, void *user_data);
+
+/**
+ * @brief             Register event set, PLAYER_NOTIFY_XXX flags are sent to it
+ *
+ * @param event       event set, RT_NULL to unregister
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_notify_set(rt_event_t event);
+
 /**
  * @brief             Set volume
  *
@@ -89,8 +271,176 @@ int wavplayer_state_get(void);
 /**
  * @brief             Get the uri that is currently playing
  *
- * @return            uri that is currently playing
+ * @return            copy of the uri that is currently playing, kept by the player until the next call
  */
 char *wavplayer_uri_get(void);
 
+/**
+ * @brief             Get wav player configuration
+ *
+ * @param config      the pointer to store the configuration
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_config_get(struct wavplayer_config *config);
+
+/**
+ * @brief             Set wav player configuration, buffer geometry takes effect from the next stream
+ *
+ * @param config      the pointer for the new configuration
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_config_set(const struct wavplayer_config *config);
+
+/**
+ * @brief             Get the number of underruns since the current stream started
+ *
+ * @return            underrun count
+ */
+int wavplayer_underrun_get(void);
+
+/**
+ * @brief             Get peak and rms of the last played block, doesn't block the player thread
+ *
+ * @param level       the pointer to store the levels
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_meter_get(struct wavmeter_level *level);
+
+/**
+ * @brief             Register the storage power hook of burst mode
+ *
+ * @param hook        hook function, RT_NULL to unregister
+ * @param user_data   user data passed to the hook
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_storage_hook_set(wavplayer_storage_hook_t hook, void *user_data);
+
+/**
+ * @brief             Get the wakeups and storage activity of the current or last stream
+ *
+ * @param stat        the pointer to store the statistics
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_power_stat_get(struct wavplayer_power_stat *stat);
+
+/**
+ * @brief             Get the load of the reader, processing and player threads
+ *
+ * @param stat        the pointer to store the statistics
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_cpu_stat_get(struct wavplayer_cpu_stat *stat);
+
+#ifdef PKG_WP_USING_DSP
+/**
+ * @brief             Append a processing stage to the playback chain, see wavdsp.h
+ *
+ * @param stage       stage object, stays owned by the caller
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_stage_add(struct wavdsp_stage *stage);
+
+/**
+ * @brief             Remove a processing stage from the playback chain
+ *
+ * @param stage       stage object
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed, the stage isn't in the chain
+ */
+int wavplayer_stage_remove(struct wavdsp_stage *stage);
+#endif
+
+/**
+ * @brief             Get the default configuration from Kconfig
+ *
+ * @param config      the pointer to store the configuration
+ */
+void wavplayer_config_default(struct wavplayer_config *config);
+
+/**
+ * @brief             Create a wav player instance with its own thread
+ *
+ * @param device_name sound device used by the instance
+ * @param config      instance configuration, RT_NULL for the default configuration
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Instance handle
+ */
+wavplayer_t wavplayer_create(const char *device_name, const struct wavplayer_config *config);
+
+/**
+ * @brief             Stop the stream and delete a wav player instance
+ *
+ * @param player      instance handle
+ *
+ * @return
+ *      - 0      Success
+ *      - others Failed
+ */
+int wavplayer_delete(wavplayer_t player);
+
+/**
+ * @brief             Get the default instance used by the wavplayer_xxx API
+ *
+ * @return            instance handle, RT_NULL if it isn't created
+ */
+wavplayer_t wavplayer_default(void);
+
+/*
+ * The following functions are the per instance variants of the functions above,
+ * they take the instance handle as the first parameter and behave the same.
+ */
+int wavplayer_inst_play(wavplayer_t player, char *uri);
+int wavplayer_inst_play_next(wavplayer_t player, char *uri);
+int wavplayer_inst_play_source(wavplayer_t player, struct wavsource *source);
+int wavplayer_inst_play_source_async(wavplayer_t player, struct wavsource *source);
+int wavplayer_inst_stop(wavplayer_t player);
+int wavplayer_inst_pause(wavplayer_t player);
+int wavplayer_inst_resume(wavplayer_t player);
+int wavplayer_inst_play_async(wavplayer_t player, char *uri);
+int wavplayer_inst_stop_async(wavplayer_t player);
+int wavplayer_inst_pause_async(wavplayer_t player);
+int wavplayer_inst_resume_async(wavplayer_t player);
+int wavplayer_inst_callback_set(wavplayer_t player, wavplayer_callback_t callback, void *user_data);
+int wavplayer_inst_notify_set(wavplayer_t player, rt_event_t event);
+int wavplayer_inst_volume_set(wavplayer_t player, int volume);
+int wavplayer_inst_volume_get(wavplayer_t player);
+int wavplayer_inst_state_get(wavplayer_t player);
+char *wavplayer_inst_uri_get(wavplayer_t player);
+int wavplayer_inst_config_get(wavplayer_t player, struct wavplayer_config *config);
+int wavplayer_inst_config_set(wavplayer_t player, const struct wavplayer_config *config);
+int wavplayer_inst_underrun_get(wavplayer_t player);
+int wavplayer_inst_meter_get(wavplayer_t player, struct wavmeter_level *level);
+int wavplayer_inst_storage_hook_set(wavplayer_t player, wavplayer_storage_hook_t hook, void *user_data);
+int wavplayer_inst_power_stat_get(wavplayer_t player, struct wavplayer_power_stat *stat);
+int wavplayer_inst_cpu_stat_get(wavplayer_t player, struct wavplayer_cpu_stat *stat);
+#ifdef PKG_WP_USING_DSP
+int wavplayer_inst_stage_add(wavplayer_t player, struct wavdsp_stage *stage);
+int wavplayer_inst_stage_remove(wavplayer_t player, struct wavdsp_stage *stage);
+#endif
+
 #endif
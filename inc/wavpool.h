@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVPOOL_H__
+#define __WAVPOOL_H__
+
+#include <rtthread.h>
+
+#ifdef PKG_WP_USING_POOL
+
+#ifndef PKG_WP_POOL_BLOCK_SIZE
+#define PKG_WP_POOL_BLOCK_SIZE (4096)
+#endif
+#ifndef PKG_WP_POOL_BLOCK_COUNT
+#define PKG_WP_POOL_BLOCK_COUNT (8)
+#endif
+#ifndef PKG_WP_POOL_ALIGN
+#define PKG_WP_POOL_ALIGN (32)
+#endif
+
+#define WAVPOOL_ALIGN        PKG_WP_POOL_ALIGN
+
+/**
+ * usage of the block pool
+ */
+struct wavpool_stat
+{
+    rt_uint32_t block_size;
+    rt_uint16_t block_count;
+    rt_uint16_t used;                       /* blocks in use */
+    rt_uint16_t used_max;                   /* high-water mark of used */
+    rt_uint32_t fallback;                   /* requests served by the heap, too large or pool empty */
+};
+
+/**
+ * @brief             Get memory of an audio buffer, a block of the static pool when it fits
+ *
+ * @param size        bytes needed
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Memory aligned to WAVPOOL_ALIGN when it comes from the pool
+ */
+void *wavpool_malloc(rt_size_t size);
+
+/**
+ * @brief             Release memory of wavpool_malloc()
+ *
+ * @param ptr         memory, RT_NULL is ignored
+ */
+void wavpool_free(void *ptr);
+
+/**
+ * @brief             Get the usage of the pool
+ *
+ * @param stat        the pointer to store the usage
+ */
+void wavpool_stat_get(struct wavpool_stat *stat);
+
+#else
+
+#define WAVPOOL_ALIGN        RT_ALIGN_SIZE
+#define wavpool_malloc(size) rt_malloc(size)
+#define wavpool_free(ptr)    rt_free(ptr)
+
+#endif /* PKG_WP_USING_POOL */
+
+#endif
@@ -11,13 +11,49 @@
 #define __WAVRECORDER_H__
 
 #include <rtthread.h>
+#include <wavmeter.h>
+
+enum WAVRECORD_ENCODING
+{
+    WAVRECORD_ENCODING_PCM      = 0,        /* samples as captured, 24 bits in 32 bits containers */
+    WAVRECORD_ENCODING_PACKED24 = 1,        /* 24 bits samples packed into 3 bytes */
+    WAVRECORD_ENCODING_FLOAT    = 2,        /* 24 or 32 bits samples written as IEEE float */
+};
 
 struct wavrecord_info
 {
     char *uri;
     rt_uint32_t samplerate;
     rt_uint16_t channels;
-    rt_uint16_t samplebits;
+    rt_uint16_t samplebits;                 /* 16, 24 or 32, 24 bits are captured in 32 bits containers */
+    rt_uint32_t split_mask;                 /* bit n writes channel n to <uri>_chn.wav, 0 for one interleaved file */
+    rt_uint8_t  encoding;                   /* WAVRECORD_ENCODING_PCM etc, how samples are stored in the file */
+    rt_uint8_t  io_backend;                 /* WAVIO_BACKEND_xxx the files are written with, mmap is read only */
+};
+
+struct rt_ringbuffer;
+
+/* called in the record thread, data is the capture buffer and only valid during the call */
+typedef void (*wavcapture_callback_t)(const void *data, rt_size_t size, void *user_data);
+
+struct wavcapture_info
+{
+    rt_uint32_t samplerate;
+    rt_uint16_t channels;
+    rt_uint16_t samplebits;                 /* 16, 24 or 32, 24 bits are captured in 32 bits containers */
+    rt_uint32_t block_size;                 /* bytes of each block, 0 for buffer_size of the configuration */
+    struct rt_ringbuffer *ring;             /* whole blocks are put into it, RT_NULL for none */
+    rt_uint32_t ring_target;                /* bytes the ring is kept at by drift compensation, 0 disables it */
+    wavcapture_callback_t callback;         /* called with each block after the ring is fed, RT_NULL for none */
+    void *user_data;
+};
+
+struct wavrecorder_config
+{
+    rt_uint32_t buffer_size;                /* bytes read from the sound device each time */
+    rt_uint32_t thread_stack_size;          /* stack size of the record thread */
+    rt_uint8_t  thread_priority;            /* priority of the record thread */
+    rt_uint8_t  meter;                      /* compute peak and rms of each captured block */
 };
 
 /**
@@ -31,6 +67,34 @@ struct wavrecord_info
  */
 rt_err_t wavrecorder_start(struct wavrecord_info *info);
 
+/**
+ * @brief             Start to capture into memory, the record device is set up like
+ *                    wavrecorder_start() and no file is written. Stop it with wavrecorder_stop().
+ *
+ * @param info        capture informations
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavrecorder_capture_start(const struct wavcapture_info *info);
+
+/**
+ * @brief             Get the blocks dropped because the ring buffer of the capture was full
+ *
+ * @return            dropped blocks since the capture started
+ */
+rt_uint32_t wavrecorder_capture_overrun_get(void);
+
+#ifdef PKG_WP_USING_ASRC
+/**
+ * @brief             Get the drift compensated between the record device and the ring consumer
+ *
+ * @return            ppm, > 0 when the consumer runs slower than the record device
+ */
+rt_int32_t wavrecorder_capture_drift_get(void);
+#endif
+
 /**
  * @brief             Stop record
  *
@@ -49,4 +113,38 @@ rt_err_t wavrecorder_stop(void);
  */
 rt_bool_t wavrecorder_is_actived(void);
 
+/**
+ * @brief             Get recorder configuration
+ *
+ * @param config      the pointer to store the configuration
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavrecorder_config_get(struct wavrecorder_config *config);
+
+/**
+ * @brief             Set recorder configuration, takes effect from the next record
+ *
+ * @param config      the pointer for the new configuration
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - -RT_EBUSY   Recorder is actived
+ *      - < 0         Failed
+ */
+rt_err_t wavrecorder_config_set(const struct wavrecorder_config *config);
+
+/**
+ * @brief             Get peak and rms of the last captured block, doesn't block the record thread
+ *
+ * @param level       the pointer to store the levels
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavrecorder_meter_get(struct wavmeter_level *level);
+
 #endif
@@ -0,0 +1,298 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVSOURCE_H__
+#define __WAVSOURCE_H__
+
+#include <rtthread.h>
+
+#ifndef PKG_WP_URI_MAX
+#define PKG_WP_URI_MAX (128)
+#endif
+
+/**
+ * pcm format of a stream source
+ */
+enum WAVSOURCE_ENCODING
+{
+    WAVSOURCE_ENCODING_PCM   = 0,           /* signed integer samples, unsigned for 8 bits */
+    WAVSOURCE_ENCODING_FLOAT = 1,           /* 32 bits IEEE float samples */
+};
+
+struct wavsource_format
+{
+    rt_uint32_t samplerate;
+    rt_uint16_t channels;
+    rt_uint16_t samplebits;
+    rt_uint16_t encoding;                   /* WAVSOURCE_ENCODING_xxx */
+};
+
+struct wavsource;
+
+struct wavsource_ops
+{
+    /* prepare the stream and report its format */
+    rt_err_t (*open)(struct wavsource *source, struct wavsource_format *format);
+    /*
+     * get up to size bytes of pcm. The source either fills buffer or points data to
+     * its own memory to avoid the copy, returns the bytes at data and 0 at the end.
+     */
+    rt_ssize_t (*read)(struct wavsource *source, void *buffer, rt_size_t size, void **data);
+    /* optional, the bytes returned by read have been played, in read order */
+    void (*release)(struct wavsource *source, void *data, rt_size_t size);
+    /* optional, move to a byte offset of the pcm data */
+    rt_err_t (*seek)(struct wavsource *source, rt_off_t offset);
+    void (*close)(struct wavsource *source);
+    /* release the source object */
+    void (*destroy)(struct wavsource *source);
+    /* optional, bytes of pcm of the opened stream, < 0 when unknown */
+    rt_ssize_t (*length)(struct wavsource *source);
+};
+
+struct wavsource
+{
+    const struct wavsource_ops *ops;
+    const char *name;                       /* uri of file sources */
+    rt_bool_t autodelete;                   /* deleted by the player when the stream is replaced */
+};
+
+/**
+ * @brief             Create a source reading a wav file with the PKG_WP_IO_BACKEND backend
+ *
+ * @param uri         the pointer for file path
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Source object
+ */
+struct wavsource *wavsource_file_create(const char *uri);
+
+/**
+ * @brief             Create a source reading a wav file with an io backend
+ *
+ * @param uri         the pointer for file path
+ * @param backend     WAVIO_BACKEND_xxx, see wavio.h
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Source object
+ */
+struct wavsource *wavsource_file_create_io(const char *uri, int backend);
+
+/**
+ * @brief             Create a source playing memory without copying it
+ *
+ * @param data        wav file image, or raw pcm when format is given
+ * @param size        bytes of data
+ * @param format      format of raw pcm, RT_NULL when data starts with a wav header
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Source object
+ */
+struct wavsource *wavsource_mem_create(const void *data, rt_size_t size, const struct wavsource_format *format);
+
+/**
+ * @brief             Create a source fed at runtime through a jitter buffer
+ *
+ * @param format      format of the pushed pcm
+ * @param capacity    bytes of the jitter buffer
+ * @param target      bytes buffered before playback starts or restarts after an underflow
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Source object
+ */
+struct wavsource *wavsource_push_create(const struct wavsource_format *format, rt_size_t capacity, rt_size_t target);
+
+/**
+ * @brief             Push pcm into a push source
+ *
+ * @param source      push source
+ * @param data        pcm data
+ * @param size        bytes of data
+ * @param timeout     ticks to wait for space
+ *
+ * @return            bytes pushed, < 0 when the stream is closed
+ */
+rt_ssize_t wavsource_push_write(struct wavsource *source, const void *data, rt_size_t size, rt_int32_t timeout);
+
+/**
+ * @brief             Mark the end of a push stream, the player stops after the buffered data
+ *
+ * @param source      push source
+ */
+void wavsource_push_finish(struct wavsource *source);
+
+/**
+ * @brief             Get bytes buffered in a push source
+ *
+ * @param source      push source
+ *
+ * @return            bytes buffered
+ */
+rt_size_t wavsource_push_level(struct wavsource *source);
+
+#ifdef PKG_WP_USING_ASRC
+/**
+ * @brief             Follow the clock of the producer by resampling the pushed pcm, the ratio is
+ *                    steered to keep the jitter buffer at its target. Only for 16 bits pcm, call it
+ *                    before the source is played or after it stopped.
+ *
+ * @param source      push source
+ * @param enable      RT_TRUE to compensate the drift, RT_FALSE to play the pcm as pushed
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - -RT_EBUSY   the source is being played
+ *      - < 0         Failed
+ */
+rt_err_t wavsource_push_drift_enable(struct wavsource *source, rt_bool_t enable);
+
+/**
+ * @brief             Get the drift compensated by a push source
+ *
+ * @param source      push source
+ *
+ * @return            ppm, > 0 when the producer runs faster than the sound device
+ */
+rt_int32_t wavsource_push_drift_get(struct wavsource *source);
+#endif
+
+/**
+ * @brief             Get the number of underflows of a push source
+ *
+ * @param source      push source
+ *
+ * @return            underflow count
+ */
+rt_uint32_t wavsource_push_underflow(struct wavsource *source);
+
+#ifdef PKG_WP_USING_STRETCH
+/**
+ * @brief             Create a source changing the speed of another one without changing its pitch,
+ *                    only 16 bits pcm is stretched, other formats are played as is
+ *
+ * @param source      source to stretch, owned and deleted by the new source
+ * @param speed       0.5 ~ 2.0, 1.0 for the original speed
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Source object
+ */
+struct wavsource *wavsource_stretch_create(struct wavsource *source, float speed);
+
+/**
+ * @brief             Change the speed of a stretch source, applied from the next segment
+ *
+ * @param source      stretch source
+ * @param speed       0.5 ~ 2.0
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavsource_stretch_set(struct wavsource *source, float speed);
+#endif
+
+#ifdef PKG_WP_USING_MIX
+/**
+ * @brief             Create a source summing other sources of the same 16 bits format. Inputs
+ *                    below the highest priority playing are ducked, the stream ends when
+ *                    every input has ended.
+ *
+ * @param format      format of the mix, RT_NULL takes the format of the first input
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Source object
+ */
+struct wavsource *wavsource_mix_create(const struct wavsource_format *format);
+
+/**
+ * @brief             Add an input to a mix, also while it is playing. The input is opened
+ *                    here, owned by the mix and deleted when it ends or can't be added.
+ *
+ * @param source      mix source
+ * @param input       source to mix
+ * @param priority    inputs of a lower priority are ducked while this one plays
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavsource_mix_add(struct wavsource *source, struct wavsource *input, int priority);
+
+/**
+ * @brief             Stop and delete an input of a mix before it ends
+ *
+ * @param source      mix source
+ * @param input       source added to the mix
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavsource_mix_remove(struct wavsource *source, struct wavsource *input);
+
+/**
+ * @brief             Set the ducking of a mix
+ *
+ * @param source      mix source
+ * @param depth       gain of the ducked inputs in dB, <= 0
+ * @param attack      ms to fade down to depth
+ * @param release     ms to fade back up after the higher priority inputs ended
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavsource_mix_duck_set(struct wavsource *source, float depth, rt_uint16_t attack, rt_uint16_t release);
+#endif
+
+#ifdef PKG_WP_USING_CROSSFADE
+/**
+ * @brief             Create a source playing a sequence of tracks with an equal power crossfade
+ *                    between them, tracks are converted to 16 bits at the channels and rate of
+ *                    the first one. The source plays once, opening it again returns -RT_EBUSY.
+ *
+ * @param source      first track, owned and deleted by the new source when autodelete is set
+ * @param time        ms of the crossfade
+ *
+ * @return
+ *      - RT_NULL Failed
+ *      - others  Source object
+ */
+struct wavsource *wavsource_xfade_create(struct wavsource *source, rt_uint16_t time);
+
+/**
+ * @brief             Queue the next track of a playing crossfade source. The track is opened and
+ *                    its first chunk read by the caller, the crossfade starts at once or when the
+ *                    current track is within the crossfade time of its end, tracks of unknown
+ *                    length are followed without a gap.
+ *
+ * @param source      crossfade source
+ * @param next        next track, owned from now on, closed and left to the caller when this fails
+ * @param now         RT_TRUE replaces the current track, RT_FALSE follows it
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavsource_xfade_next(struct wavsource *source, struct wavsource *next, rt_bool_t now);
+#endif
+
+/**
+ * @brief             Delete a source that isn't used by a player
+ *
+ * @param source      source object
+ */
+void wavsource_delete(struct wavsource *source);
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#ifndef __WAVTRACE_H__
+#define __WAVTRACE_H__
+
+#include <rtthread.h>
+
+#ifndef PKG_WP_TRACE_SIZE
+#define PKG_WP_TRACE_SIZE (512)
+#endif
+
+/**
+ * events of the player and the recorder, durations are recorded as a begin and an end
+ */
+enum WAVTRACE_EVENT
+{
+    WAVTRACE_EVENT_START   = 0,             /* player, start request handled */
+    WAVTRACE_EVENT_STOP    = 1,             /* player, stop request handled */
+    WAVTRACE_EVENT_PAUSE   = 2,             /* player, pause request handled */
+    WAVTRACE_EVENT_RESUME  = 3,             /* player, resume request handled */
+    WAVTRACE_EVENT_OPEN    = 4,             /* player, stream and device opened, arg is the result */
+    WAVTRACE_EVENT_READ    = 5,             /* player, block read from the source, arg is bytes */
+    WAVTRACE_EVENT_PROCESS = 6,             /* player, block processed for the device, arg is bytes */
+    WAVTRACE_EVENT_WRITE   = 7,             /* player, block written to the device, arg is bytes */
+    WAVTRACE_EVENT_EOS     = 8,             /* player, end of stream reached */
+    WAVTRACE_EVENT_CAPTURE = 9,             /* recorder, block read from the device, arg is bytes */
+    WAVTRACE_EVENT_SAVE    = 10,            /* recorder, block written to the file, arg is bytes */
+    WAVTRACE_EVENT_MAX,
+};
+
+enum WAVTRACE_PHASE
+{
+    WAVTRACE_PHASE_BEGIN   = 0,
+    WAVTRACE_PHASE_END     = 1,
+    WAVTRACE_PHASE_INSTANT = 2,
+};
+
+/**
+ * one recorded event
+ */
+struct wavtrace_entry
+{
+    rt_uint32_t time;                       /* us, wraps after about 71 minutes */
+    rt_uint32_t arg;
+    rt_uint8_t event;                       /* WAVTRACE_EVENT_xxx */
+    rt_uint8_t phase;                       /* WAVTRACE_PHASE_xxx */
+    char thread[RT_NAME_MAX];               /* name of the recording thread */
+};
+
+#ifdef PKG_WP_USING_TRACE
+#define WAVTRACE_BEGIN(event, arg)   wavtrace_record(event, WAVTRACE_PHASE_BEGIN, arg)
+#define WAVTRACE_END(event, arg)     wavtrace_record(event, WAVTRACE_PHASE_END, arg)
+#define WAVTRACE_INSTANT(event, arg) wavtrace_record(event, WAVTRACE_PHASE_INSTANT, arg)
+#else
+#define WAVTRACE_BEGIN(event, arg)
+#define WAVTRACE_END(event, arg)
+#define WAVTRACE_INSTANT(event, arg)
+#endif
+
+/**
+ * @brief             Record an event from any thread, does nothing while tracing is off.
+ *                    The slot is claimed with an atomic increment and the oldest event
+ *                    is overwritten when the ring is full.
+ *
+ * @param event       WAVTRACE_EVENT_xxx
+ * @param phase       WAVTRACE_PHASE_xxx
+ * @param arg         value of the event
+ */
+void wavtrace_record(int event, int phase, rt_uint32_t arg);
+
+/**
+ * @brief             Turn tracing on or off, it is off at startup
+ *
+ * @param enable      RT_TRUE to record events
+ */
+void wavtrace_enable(rt_bool_t enable);
+
+/**
+ * @brief             Drop the recorded events
+ */
+void wavtrace_clear(void);
+
+/**
+ * @brief             Copy the recorded events, oldest first. Tracing is paused while they are
+ *                    copied, events recorded meanwhile are lost. An event whose writer hasn't
+ *                    finished it yet is skipped, fewer entries than recorded may be returned.
+ *
+ * @param entries     array of count entries
+ * @param count       entries at most
+ *
+ * @return            entries copied
+ */
+rt_size_t wavtrace_read(struct wavtrace_entry *entries, rt_size_t count);
+
+/**
+ * @brief             Get the name of an event
+ *
+ * @param event       WAVTRACE_EVENT_xxx
+ *
+ * @return            event name, "unknown" when out of range
+ */
+const char *wavtrace_event_name(int event);
+
+/**
+ * @brief             Write the recorded events as Chrome trace JSON, which chrome://tracing
+ *                    and Perfetto show as a timeline
+ *
+ * @param path        file to create, RT_NULL prints to the console
+ *
+ * @return
+ *      - RT_EOK      Success
+ *      - < 0         Failed
+ */
+rt_err_t wavtrace_export(const char *path);
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <wavasrc.h>
+
+#define ASRC_ONE             (1ULL << 32)
+
+/*
+ * Loop of the drift estimation. The correction is a PI controller on the fill
+ * level error, proportional time constant ASRC_TP and integral time ASRC_TI in
+ * seconds, critically damped for TI = 4 * TP. The level is smoothed over
+ * ASRC_TS seconds against the burst arrival of blocks.
+ */
+#define ASRC_TP              (1.0f)
+#define ASRC_TI              (4.0f)
+#define ASRC_TS              (0.2f)
+
+rt_err_t wavasrc_init(struct wavasrc *asrc, rt_uint32_t samplerate, int channels)
+{
+    if (asrc == RT_NULL || samplerate == 0 || channels <= 0 || channels > PKG_WP_ASRC_CHANNELS_MAX)
+        return -RT_EINVAL;
+
+    rt_memset(asrc, 0, sizeof(struct wavasrc));
+    asrc->channels = channels;
+    asrc->samplerate = samplerate;
+    asrc->step = ASRC_ONE;
+    /* the first output waits for the history to be filled */
+    asrc->phase = 3 * ASRC_ONE;
+
+    return RT_EOK;
+}
+
+void wavasrc_update(struct wavasrc *asrc, rt_size_t level, rt_size_t target, rt_size_t frames)
+{
+    float fs = (float)asrc->samplerate;
+    float dt = (float)frames / fs;
+    float error = (float)level - (float)target;
+    float alpha, limit = PKG_WP_ASRC_PPM_MAX * 1e-6f;
+
+    if (frames == 0)
+        return;
+
+    alpha = dt / ASRC_TS;
+    if (alpha > 1.0f)
+        alpha = 1.0f;
+    asrc->level += (error - asrc->level) * alpha;
+
+    /* a level error of e frames is drained in TP seconds */
+    asrc->integral += asrc->level / (fs * ASRC_TP) * dt / ASRC_TI;
+    if (asrc->integral > limit)
+        asrc->integral = limit;
+    else if (asrc->integral < -limit)
+        asrc->integral = -limit;
+
+    asrc->correction = asrc->level / (fs * ASRC_TP) + asrc->integral;
+    if (asrc->correction > limit)
+        asrc->correction = limit;
+    else if (asrc->correction < -limit)
+        asrc->correction = -limit;
+
+    asrc->step = (rt_uint64_t)((rt_int64_t)ASRC_ONE + (rt_int64_t)(asrc->correction * 4294967296.0f));
+}
+
+/*
+ * Cubic Hermite (Catmull-Rom) between hist[1] and hist[2], with twice the
+ * polynomial coefficients kept in integers and t in Q15:
+ *   2y = 2x0 + ((c3 t + c2) t + c1) t
+ */
+static rt_int16_t asrc_cubic(rt_int32_t xm1, rt_int32_t x0, rt_int32_t x1, rt_int32_t x2, rt_int32_t t)
+{
+    rt_int32_t c1 = x1 - xm1;
+    rt_int32_t c2 = 2 * xm1 - 5 * x0 + 4 * x1 - x2;
+    rt_int32_t c3 = x2 - xm1 + 3 * (x0 - x1);
+    rt_int64_t acc;
+    rt_int32_t y;
+
+    acc = ((rt_int64_t)c3 * t >> 15) + c2;
+    acc = (acc * t >> 15) + c1;
+    acc = acc * t >> 15;
+    y = x0 + (rt_int32_t)((acc + 1) >> 1);
+
+    if (y > 32767)
+        y = 32767;
+    else if (y < -32768)
+        y = -32768;
+
+    return (rt_int16_t)y;
+}
+
+rt_size_t wavasrc_process(struct wavasrc *asrc, const rt_int16_t *in, rt_size_t in_frames,
+                          rt_int16_t *out, rt_size_t out_frames, rt_size_t *consumed)
+{
+    int channels = asrc->channels, c;
+    rt_size_t used = 0, produced = 0;
+    rt_int32_t t;
+
+    while (produced < out_frames)
+    {
+        /* move the history forward to the frame before the output position */
+        while (asrc->phase >= ASRC_ONE)
+        {
+            if (used == in_frames)
+                goto __exit;
+
+            rt_memmove(asrc->hist[0], asrc->hist[1], 3 * sizeof(asrc->hist[0]));
+            rt_memcpy(asrc->hist[3], in, channels * sizeof(rt_int16_t));
+            in += channels;
+            used++;
+            asrc->phase -= ASRC_ONE;
+        }
+
+        t = (rt_int32_t)(asrc->phase >> 17);
+        for (c = 0; c < channels; c++)
+            out[c] = asrc_cubic(asrc->hist[0][c], asrc->hist[1][c], asrc->hist[2][c], asrc->hist[3][c], t);
+        out += channels;
+        produced++;
+        asrc->phase += asrc->step;
+    }
+
+__exit:
+    if (consumed)
+        *consumed = used;
+
+    return produced;
+}
+
+rt_int32_t wavasrc_ppm_get(const struct wavasrc *asrc)
+{
+    float ppm = asrc->correction * 1e6f;
+
+    return (rt_int32_t)(ppm >= 0 ? ppm + 0.5f : ppm - 0.5f);
+}
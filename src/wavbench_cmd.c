@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavio.h>
+#ifdef PKG_WP_USING_DSP
+#include <wavdsp.h>
+#endif
+
+#include <string.h>
+
+#define BENCH_FRAMES         (512)
+#define BENCH_CHANNELS       (2)
+#define BENCH_SAMPLERATE     (48000)
+#define BENCH_IO_BLOCK       (4096)
+
+/* cycle counter of ARMv7-M/ARMv8-M, other targets report time per sample instead */
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define BENCH_USING_DWT
+#define DEMCR                (*(volatile rt_uint32_t *)0xE000EDFC)
+#define DWT_CTRL             (*(volatile rt_uint32_t *)0xE0001000)
+#define DWT_CYCCNT           (*(volatile rt_uint32_t *)0xE0001004)
+#endif
+
+#ifdef PKG_WP_USING_DSP
+static void bench_counter_init(void)
+{
+#ifdef BENCH_USING_DWT
+    DEMCR |= (1UL << 24);
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= 1UL;
+#endif
+}
+
+static rt_uint32_t bench_counter_get(void)
+{
+#ifdef BENCH_USING_DWT
+    return DWT_CYCCNT;
+#else
+    return rt_tick_get();
+#endif
+}
+
+static void bench_report(const char *name, rt_uint64_t count, rt_uint64_t samples)
+{
+#ifdef BENCH_USING_DWT
+    rt_uint32_t value = (rt_uint32_t)(count * 100 / samples);
+
+    rt_kprintf("%-24s %4d.%02d cycles/sample\n", name, value / 100, value % 100);
+#else
+    rt_uint32_t value = (rt_uint32_t)(count * 1000000000ULL / RT_TICK_PER_SECOND / samples);
+
+    rt_kprintf("%-24s %8d ns/sample\n", name, value);
+#endif
+}
+
+static void bench_fill(rt_int16_t *buffer, rt_size_t count)
+{
+    rt_uint32_t seed = 0x12345678;
+    rt_size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        buffer[i] = (rt_int16_t)(seed >> 20);
+    }
+}
+
+/* time a stage on blocks of noise for half a second */
+static void bench_stage(struct wavdsp_stage *stage, const char *name, rt_int16_t *buffer, rt_int32_t *work)
+{
+    rt_uint64_t count = 0, samples = 0;
+    rt_uint32_t start;
+    rt_tick_t tick;
+
+    /* the first block prepares the stage */
+    bench_fill(buffer, BENCH_FRAMES * BENCH_CHANNELS);
+    wavdsp_chain_process(stage, buffer, work, BENCH_FRAMES, BENCH_SAMPLERATE, BENCH_CHANNELS);
+
+    tick = rt_tick_get();
+    do
+    {
+        start = bench_counter_get();
+        wavdsp_chain_process(stage, buffer, work, BENCH_FRAMES, BENCH_SAMPLERATE, BENCH_CHANNELS);
+        count += (rt_uint32_t)(bench_counter_get() - start);
+        samples += BENCH_FRAMES * BENCH_CHANNELS;
+    }
+    while (rt_tick_get() - tick < RT_TICK_PER_SECOND / 2);
+
+    bench_report(name, count, samples);
+}
+
+static int bench_eq(rt_int16_t *buffer, rt_int32_t *work)
+{
+    struct wavdsp_stage *stage;
+    struct wavdsp_band band;
+    char name[32];
+    int format, sections, i;
+
+    for (format = WAVDSP_EQ_Q31; format <= WAVDSP_EQ_F32; format++)
+    {
+        for (sections = 1; sections <= PKG_WP_EQ_SECTIONS_MAX; sections++)
+        {
+            stage = wavdsp_eq_create(sections, format);
+            if (stage == RT_NULL)
+                return -RT_ENOMEM;
+
+            for (i = 0; i < sections; i++)
+            {
+                band.type = WAVDSP_BAND_PEAK;
+                band.freq = 100.0f * (i + 1) * (i + 1);
+                band.q = 1.0f;
+                band.gain = (i & 1) ? -3.0f : 3.0f;
+                wavdsp_eq_band_set(stage, i, &band);
+            }
+
+            rt_snprintf(name, sizeof(name), "eq %s %d sections", format == WAVDSP_EQ_Q31 ? "q31" : "f32", sections);
+            bench_stage(stage, name, buffer, work);
+            wavdsp_stage_delete(stage);
+        }
+    }
+
+    return RT_EOK;
+}
+
+static int bench_limiter(rt_int16_t *buffer, rt_int32_t *work)
+{
+    struct wavdsp_stage *stage;
+    struct wavdsp_dynamics params =
+    {
+        .ceiling      = -6.0f,
+        .lookahead    = 2.0f,
+        .release      = 50.0f,
+        .compressor   = 0,
+        .threshold    = -18.0f,
+        .ratio        = 4.0f,
+        .attack       = 5.0f,
+        .comp_release = 100.0f,
+        .makeup       = 6.0f,
+    };
+
+    stage = wavdsp_limiter_create(&params);
+    if (stage == RT_NULL)
+        return -RT_ENOMEM;
+    bench_stage(stage, "limiter", buffer, work);
+
+    params.compressor = 1;
+    wavdsp_limiter_set(stage, &params);
+    bench_stage(stage, "limiter + compressor", buffer, work);
+
+    stage->bypass = RT_TRUE;
+    bench_stage(stage, "limiter bypassed", buffer, work);
+    wavdsp_stage_delete(stage);
+
+    return RT_EOK;
+}
+
+static int bench_dsp(const char *target)
+{
+    rt_int16_t *buffer;
+    rt_int32_t *work;
+    int result;
+
+    buffer = rt_malloc(BENCH_FRAMES * BENCH_CHANNELS * sizeof(rt_int16_t));
+    work = rt_malloc(BENCH_FRAMES * BENCH_CHANNELS * sizeof(rt_int32_t));
+    if (buffer == RT_NULL || work == RT_NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    bench_counter_init();
+    rt_kprintf("%d Hz, %d channels, %d frames per block\n", BENCH_SAMPLERATE, BENCH_CHANNELS, BENCH_FRAMES);
+
+    if (strcmp(target, "eq") == 0)
+        result = bench_eq(buffer, work);
+    else
+        result = bench_limiter(buffer, work);
+
+__exit:
+    if (buffer)
+        rt_free(buffer);
+    if (work)
+        rt_free(work);
+
+    return result;
+}
+#endif /* PKG_WP_USING_DSP */
+
+#ifdef RT_USING_IDLE_HOOK
+static volatile rt_uint32_t bench_idle_count;
+
+static void bench_idle_hook(void)
+{
+    bench_idle_count++;
+}
+#endif
+
+/* read a file to the end the way the player does, the bytes are summed so mapped pages are touched */
+static rt_err_t bench_io_read(const char *path, int backend, rt_uint8_t *buffer,
+                              rt_uint64_t *bytes, rt_uint32_t *sum)
+{
+    struct wavio io;
+    rt_ssize_t length, i;
+    void *data;
+
+    if (wavio_open(&io, path, WAVIO_MODE_READ, backend) != RT_EOK)
+        return -RT_ERROR;
+
+    *bytes = 0;
+    *sum = 0;
+    while ((length = wavio_read_ref(&io, buffer, BENCH_IO_BLOCK, &data)) > 0)
+    {
+        for (i = 0; i < length; i += 4)
+            *sum += ((rt_uint8_t *)data)[i];
+        *bytes += length;
+    }
+    wavio_close(&io);
+
+    return RT_EOK;
+}
+
+/* throughput of each io backend on the same file, the cpu load comes from the idle thread */
+static int bench_io(const char *path, rt_uint8_t *buffer)
+{
+    rt_uint64_t bytes;
+    rt_uint32_t sum, idle_rate = 0, ticks;
+    rt_tick_t tick;
+    int backend, load, result = RT_EOK;
+
+#ifdef RT_USING_IDLE_HOOK
+    if (rt_thread_idle_sethook(bench_idle_hook) != RT_EOK)
+        return -RT_EFULL;
+
+    /* idle loops per tick of an idle system */
+    bench_idle_count = 0;
+    rt_thread_delay(RT_TICK_PER_SECOND / 2);
+    idle_rate = bench_idle_count / (RT_TICK_PER_SECOND / 2);
+#endif
+
+    /* every backend starts from the same file system cache */
+    if (bench_io_read(path, WAVIO_BACKEND_STDIO, buffer, &bytes, &sum) != RT_EOK)
+    {
+        rt_kprintf("open %s failed\n", path);
+        result = -RT_ERROR;
+        goto __exit;
+    }
+    rt_kprintf("%s, %d bytes, %d bytes per read\n", path, (rt_uint32_t)bytes, BENCH_IO_BLOCK);
+
+    for (backend = 0; backend < WAVIO_BACKEND_MAX; backend++)
+    {
+#ifdef RT_USING_IDLE_HOOK
+        bench_idle_count = 0;
+#endif
+        tick = rt_tick_get();
+        if (bench_io_read(path, backend, buffer, &bytes, &sum) != RT_EOK)
+        {
+            rt_kprintf("%-8s not supported\n", wavio_backend_name(backend));
+            continue;
+        }
+        ticks = rt_tick_get() - tick;
+        if (ticks == 0)
+            ticks = 1;
+
+        /* -1 when the idle hook isn't available */
+        load = -1;
+        if (idle_rate > 0)
+        {
+#ifdef RT_USING_IDLE_HOOK
+            load = 100 - (int)((rt_uint64_t)bench_idle_count * 100 / ((rt_uint64_t)idle_rate * ticks));
+#endif
+            if (load < 0)
+                load = 0;
+        }
+
+        rt_kprintf("%-8s %8d KB/s %6d ms cpu %3d%% sum %08x\n", wavio_backend_name(backend),
+                   (rt_uint32_t)(bytes * RT_TICK_PER_SECOND / ticks / 1024),
+                   (rt_uint32_t)((rt_uint64_t)ticks * 1000 / RT_TICK_PER_SECOND), load, sum);
+    }
+
+__exit:
+#ifdef RT_USING_IDLE_HOOK
+    rt_thread_idle_delhook(bench_idle_hook);
+#endif
+
+    return result;
+}
+
+static void usage(void)
+{
+    rt_kprintf("usage: wavbench <target>\n\n");
+    rt_kprintf("targets:\n");
+#ifdef PKG_WP_USING_DSP
+    rt_kprintf("  eq      Biquad cascade of 1 ~ %d sections, q31 and f32.\n", PKG_WP_EQ_SECTIONS_MAX);
+    rt_kprintf("  limiter Look-ahead limiter with and without compressor.\n");
+#endif
+    rt_kprintf("  io file Read a file with each io backend, throughput and cpu load.\n");
+}
+
+int wav_bench(int argc, char *argv[])
+{
+    rt_uint8_t *buffer;
+    int result;
+
+    if (argc == 3 && strcmp(argv[1], "io") == 0)
+    {
+        buffer = rt_malloc(BENCH_IO_BLOCK);
+        if (buffer == RT_NULL)
+            return -RT_ENOMEM;
+        result = bench_io(argv[2], buffer);
+        rt_free(buffer);
+        return result;
+    }
+
+#ifdef PKG_WP_USING_DSP
+    if (argc == 2 && (strcmp(argv[1], "eq") == 0 || strcmp(argv[1], "limiter") == 0))
+        return bench_dsp(argv[1]);
+#endif
+
+    usage();
+
+    return -RT_ERROR;
+}
+
+MSH_CMD_EXPORT_ALIAS(wav_bench, wavbench, benchmark wavplayer processing kernels);
@@ -0,0 +1,928 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavdsp.h>
+#include <wavpool.h>
+
+#include <math.h>
+
+#ifdef PKG_WP_USING_CMSIS_DSP
+#include <arm_math.h>
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define DBG_TAG              "WAV_DSP"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+#define DSP_PI               (3.14159265f)
+
+#define EQ_CHUNK             (64)           /* frames converted to the working format at a time */
+#define EQ_HEADROOM          (4)            /* bits of q31 kept above 16 bits full scale */
+#define EQ_STATE_SIZE        (4)            /* state words of a section, df1 q31 uses 4, tdf2 f32 uses 2 */
+#define EQ_COEFF_SIZE        (5)
+
+enum EQ_SECTION_MODE
+{
+    EQ_SECTION_OFF   = 0,
+    EQ_SECTION_BAND  = 1,
+    EQ_SECTION_COEFF = 2,
+};
+
+struct eq_section
+{
+    int mode;
+    struct wavdsp_band band;
+    struct wavdsp_biquad coeff;
+};
+
+#ifdef PKG_WP_USING_CMSIS_DSP
+union eq_inst
+{
+    arm_biquad_casd_df1_inst_q31 q31;
+    arm_biquad_cascade_df2T_instance_f32 f32;
+};
+#endif
+
+struct wavdsp_eq
+{
+    struct wavdsp_stage parent;
+    int format;
+    int sections;
+
+    /* written by the control threads, taken by the player thread at block boundaries */
+    struct eq_section pending[PKG_WP_EQ_SECTIONS_MAX];
+    volatile rt_bool_t dirty;
+
+    /* owned by the player thread, feedback coefficients are stored negated */
+    rt_bool_t active;
+    int shift;
+    rt_int32_t coeff_q31[PKG_WP_EQ_SECTIONS_MAX * EQ_COEFF_SIZE];
+    float coeff_f32[PKG_WP_EQ_SECTIONS_MAX * EQ_COEFF_SIZE];
+    rt_int32_t *state;                      /* EQ_STATE_SIZE words per section per channel */
+    int channels;
+#ifdef PKG_WP_USING_CMSIS_DSP
+    union eq_inst *inst;                    /* one per channel */
+#endif
+
+    union
+    {
+        rt_int32_t q31[EQ_CHUNK];
+        float f32[EQ_CHUNK * 2];
+    } scratch;
+};
+
+static rt_int16_t dsp_saturate16(rt_int32_t value)
+{
+    if (value > 32767)
+        return 32767;
+    if (value < -32768)
+        return -32768;
+    return (rt_int16_t)value;
+}
+
+static rt_int32_t dsp_clamp(rt_int32_t value)
+{
+    if (value >= WAVDSP_SAMPLE_LIMIT)
+        return WAVDSP_SAMPLE_LIMIT - 1;
+    if (value < -WAVDSP_SAMPLE_LIMIT)
+        return -WAVDSP_SAMPLE_LIMIT;
+    return value;
+}
+
+static rt_int32_t dsp_from_float(float value)
+{
+    if (value >= (float)WAVDSP_SAMPLE_LIMIT)
+        return WAVDSP_SAMPLE_LIMIT - 1;
+    if (value < -(float)WAVDSP_SAMPLE_LIMIT)
+        return -WAVDSP_SAMPLE_LIMIT;
+    return (rt_int32_t)lrintf(value);
+}
+
+void wavdsp_chain_process(struct wavdsp_stage *chain, rt_int16_t *data, rt_int32_t *work, rt_size_t frames,
+                          rt_uint32_t samplerate, int channels)
+{
+    struct wavdsp_stage *stage;
+    rt_size_t i, count = frames * channels;
+
+    for (i = 0; i < count; i++)
+        work[i] = data[i];
+
+    for (stage = chain; stage != RT_NULL; stage = stage->next)
+    {
+        /* a stage added in the middle of a stream is prepared at its first block */
+        if (stage->samplerate != samplerate || stage->channels != channels)
+        {
+            stage->samplerate = samplerate;
+            stage->channels = channels;
+            stage->idle = RT_FALSE;
+            stage->ready = stage->ops->prepare ? (stage->ops->prepare(stage, samplerate, channels) == RT_EOK) : RT_TRUE;
+            if (stage->ready == RT_FALSE)
+                LOG_W("stage %s doesn't support %d Hz %d channels", stage->name, samplerate, channels);
+        }
+
+        if (stage->ready == RT_FALSE)
+            continue;
+
+        /* a bypassed stage adds no latency, its history is stale when it comes back */
+        if (stage->bypass)
+        {
+            stage->idle = RT_TRUE;
+            continue;
+        }
+        if (stage->idle && stage->ops->reset)
+            stage->ops->reset(stage);
+        stage->idle = RT_FALSE;
+
+        stage->ops->process(stage, work, frames);
+    }
+
+    for (i = 0; i < count; i++)
+        data[i] = dsp_saturate16(work[i]);
+}
+
+void wavdsp_chain_reset(struct wavdsp_stage *chain)
+{
+    struct wavdsp_stage *stage;
+
+    for (stage = chain; stage != RT_NULL; stage = stage->next)
+    {
+        stage->samplerate = 0;
+        stage->channels = 0;
+    }
+}
+
+void wavdsp_stage_delete(struct wavdsp_stage *stage)
+{
+    RT_ASSERT(stage != RT_NULL);
+
+    stage->ops->destroy(stage);
+}
+
+rt_err_t wavdsp_biquad_design(struct wavdsp_biquad *coeff, const struct wavdsp_band *band, rt_uint32_t samplerate)
+{
+    float a, w0, cosw, alpha, sqa, a0;
+
+    if (band->freq <= 0.0f || band->freq >= samplerate / 2.0f || band->q <= 0.0f)
+        return -RT_EINVAL;
+
+    a = powf(10.0f, band->gain / 40.0f);
+    w0 = 2.0f * DSP_PI * band->freq / samplerate;
+    cosw = cosf(w0);
+    alpha = sinf(w0) / (2.0f * band->q);
+    sqa = 2.0f * sqrtf(a) * alpha;
+
+    /* audio EQ cookbook */
+    switch (band->type)
+    {
+    case WAVDSP_BAND_PEAK:
+        coeff->b0 = 1.0f + alpha * a;
+        coeff->b1 = -2.0f * cosw;
+        coeff->b2 = 1.0f - alpha * a;
+        a0        = 1.0f + alpha / a;
+        coeff->a1 = -2.0f * cosw;
+        coeff->a2 = 1.0f - alpha / a;
+        break;
+
+    case WAVDSP_BAND_LOWSHELF:
+        coeff->b0 = a * ((a + 1.0f) - (a - 1.0f) * cosw + sqa);
+        coeff->b1 = 2.0f * a * ((a - 1.0f) - (a + 1.0f) * cosw);
+        coeff->b2 = a * ((a + 1.0f) - (a - 1.0f) * cosw - sqa);
+        a0        = (a + 1.0f) + (a - 1.0f) * cosw + sqa;
+        coeff->a1 = -2.0f * ((a - 1.0f) + (a + 1.0f) * cosw);
+        coeff->a2 = (a + 1.0f) + (a - 1.0f) * cosw - sqa;
+        break;
+
+    case WAVDSP_BAND_HIGHSHELF:
+        coeff->b0 = a * ((a + 1.0f) + (a - 1.0f) * cosw + sqa);
+        coeff->b1 = -2.0f * a * ((a - 1.0f) + (a + 1.0f) * cosw);
+        coeff->b2 = a * ((a + 1.0f) + (a - 1.0f) * cosw - sqa);
+        a0        = (a + 1.0f) - (a - 1.0f) * cosw + sqa;
+        coeff->a1 = 2.0f * ((a - 1.0f) - (a + 1.0f) * cosw);
+        coeff->a2 = (a + 1.0f) - (a - 1.0f) * cosw - sqa;
+        break;
+
+    case WAVDSP_BAND_LOWPASS:
+        coeff->b0 = (1.0f - cosw) / 2.0f;
+        coeff->b1 = 1.0f - cosw;
+        coeff->b2 = (1.0f - cosw) / 2.0f;
+        a0        = 1.0f + alpha;
+        coeff->a1 = -2.0f * cosw;
+        coeff->a2 = 1.0f - alpha;
+        break;
+
+    case WAVDSP_BAND_HIGHPASS:
+        coeff->b0 = (1.0f + cosw) / 2.0f;
+        coeff->b1 = -(1.0f + cosw);
+        coeff->b2 = (1.0f + cosw) / 2.0f;
+        a0        = 1.0f + alpha;
+        coeff->a1 = -2.0f * cosw;
+        coeff->a2 = 1.0f - alpha;
+        break;
+
+    default:
+        return -RT_EINVAL;
+    }
+
+    coeff->b0 /= a0;
+    coeff->b1 /= a0;
+    coeff->b2 /= a0;
+    coeff->a1 /= a0;
+    coeff->a2 /= a0;
+
+    return RT_EOK;
+}
+
+/* direct form I, the state keeps signal values so a coefficient change doesn't disturb it */
+static void eq_df1_q31(const rt_int32_t *coeff, rt_int32_t *state, int sections, int shift,
+                       rt_int32_t *buffer, rt_size_t count)
+{
+    rt_int32_t b0, b1, b2, a1, a2, x, x1, x2, y, y1, y2;
+    rt_int64_t acc;
+    rt_size_t i;
+    int s;
+
+    for (s = 0; s < sections; s++)
+    {
+        b0 = coeff[0];
+        b1 = coeff[1];
+        b2 = coeff[2];
+        a1 = coeff[3];
+        a2 = coeff[4];
+        x1 = state[0];
+        x2 = state[1];
+        y1 = state[2];
+        y2 = state[3];
+
+        for (i = 0; i < count; i++)
+        {
+            x = buffer[i];
+            acc = (rt_int64_t)b0 * x + (rt_int64_t)b1 * x1 + (rt_int64_t)b2 * x2 +
+                  (rt_int64_t)a1 * y1 + (rt_int64_t)a2 * y2;
+            y = (rt_int32_t)(acc >> (31 - shift));
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            buffer[i] = y;
+        }
+
+        state[0] = x1;
+        state[1] = x2;
+        state[2] = y1;
+        state[3] = y2;
+        coeff += EQ_COEFF_SIZE;
+        state += EQ_STATE_SIZE;
+    }
+}
+
+/* transposed direct form II */
+static void eq_tdf2_f32(const float *coeff, float *state, int sections, float *buffer, rt_size_t count)
+{
+    float b0, b1, b2, a1, a2, x, y, d1, d2;
+    rt_size_t i;
+    int s;
+
+    for (s = 0; s < sections; s++)
+    {
+        b0 = coeff[0];
+        b1 = coeff[1];
+        b2 = coeff[2];
+        a1 = coeff[3];
+        a2 = coeff[4];
+        d1 = state[0];
+        d2 = state[1];
+
+        for (i = 0; i < count; i++)
+        {
+            x = buffer[i];
+            y = b0 * x + d1;
+            d1 = b1 * x + a1 * y + d2;
+            d2 = b2 * x + a2 * y;
+            buffer[i] = y;
+        }
+
+        state[0] = d1;
+        state[1] = d2;
+        coeff += EQ_COEFF_SIZE;
+        state += 2;
+    }
+}
+
+#if defined(__ARM_NEON) && !defined(PKG_WP_USING_CMSIS_DSP)
+/* stereo transposed direct form II, both channels of a frame in one vector */
+static void eq_tdf2_f32_stereo(const float *coeff, float *left, float *right, int sections,
+                               float *buffer, rt_size_t count)
+{
+    float32x2_t x, y, d1, d2;
+    rt_size_t i;
+    int s;
+
+    for (s = 0; s < sections; s++)
+    {
+        d1 = vset_lane_f32(right[0], vdup_n_f32(left[0]), 1);
+        d2 = vset_lane_f32(right[1], vdup_n_f32(left[1]), 1);
+
+        for (i = 0; i < count; i++)
+        {
+            x = vld1_f32(buffer + i * 2);
+            y = vmla_n_f32(d1, x, coeff[0]);
+            d1 = vmla_n_f32(vmla_n_f32(d2, x, coeff[1]), y, coeff[3]);
+            d2 = vmla_n_f32(vmul_n_f32(x, coeff[2]), y, coeff[4]);
+            vst1_f32(buffer + i * 2, y);
+        }
+
+        left[0] = vget_lane_f32(d1, 0);
+        right[0] = vget_lane_f32(d1, 1);
+        left[1] = vget_lane_f32(d2, 0);
+        right[1] = vget_lane_f32(d2, 1);
+        coeff += EQ_COEFF_SIZE;
+        left += 2;
+        right += 2;
+    }
+}
+#endif
+
+/* take the pending sections, the filter state is kept so the change doesn't click */
+static void eq_update(struct wavdsp_eq *eq)
+{
+    struct eq_section section[PKG_WP_EQ_SECTIONS_MAX];
+    struct wavdsp_biquad coeff;
+    float max = 0.0f, value;
+    int i, k;
+
+    if (eq->dirty == RT_FALSE)
+        return;
+
+    rt_enter_critical();
+    rt_memcpy(section, eq->pending, sizeof(struct eq_section) * eq->sections);
+    eq->dirty = RT_FALSE;
+    rt_exit_critical();
+
+    eq->active = RT_FALSE;
+    for (i = 0; i < eq->sections; i++)
+    {
+        switch (section[i].mode)
+        {
+        case EQ_SECTION_COEFF:
+            coeff = section[i].coeff;
+            eq->active = RT_TRUE;
+            break;
+
+        case EQ_SECTION_BAND:
+            if (wavdsp_biquad_design(&coeff, &section[i].band, eq->parent.samplerate) == RT_EOK)
+            {
+                eq->active = RT_TRUE;
+                break;
+            }
+            /* a band out of range for this samplerate passes through */
+
+        default:
+            /* pass through keeps the position of the other sections in the state */
+            rt_memset(&coeff, 0, sizeof(coeff));
+            coeff.b0 = 1.0f;
+            break;
+        }
+
+        eq->coeff_f32[i * EQ_COEFF_SIZE + 0] = coeff.b0;
+        eq->coeff_f32[i * EQ_COEFF_SIZE + 1] = coeff.b1;
+        eq->coeff_f32[i * EQ_COEFF_SIZE + 2] = coeff.b2;
+        eq->coeff_f32[i * EQ_COEFF_SIZE + 3] = -coeff.a1;
+        eq->coeff_f32[i * EQ_COEFF_SIZE + 4] = -coeff.a2;
+    }
+
+    if (eq->format == WAVDSP_EQ_Q31)
+    {
+        /* one post shift for the cascade, large enough for the largest coefficient */
+        for (k = 0; k < eq->sections * EQ_COEFF_SIZE; k++)
+        {
+            value = fabsf(eq->coeff_f32[k]);
+            if (value > max)
+                max = value;
+        }
+        for (eq->shift = 0; max >= 1.0f && eq->shift < 7; eq->shift++)
+            max /= 2.0f;
+
+        for (k = 0; k < eq->sections * EQ_COEFF_SIZE; k++)
+        {
+            double q = (double)eq->coeff_f32[k] / (1 << eq->shift) * 2147483648.0;
+            eq->coeff_q31[k] = q >= 2147483647.0 ? 0x7FFFFFFF : (rt_int32_t)q;
+        }
+    }
+
+#ifdef PKG_WP_USING_CMSIS_DSP
+    for (i = 0; i < eq->channels; i++)
+    {
+        if (eq->format == WAVDSP_EQ_Q31)
+            eq->inst[i].q31.postShift = eq->shift;
+    }
+#endif
+}
+
+static rt_err_t eq_prepare(struct wavdsp_stage *stage, rt_uint32_t samplerate, int channels)
+{
+    struct wavdsp_eq *eq = (struct wavdsp_eq *)stage;
+    rt_size_t size = eq->sections * EQ_STATE_SIZE * sizeof(rt_int32_t);
+    int i;
+
+    if (eq->channels != channels)
+    {
+        wavpool_free(eq->state);
+        eq->state = wavpool_malloc(size * channels);
+#ifdef PKG_WP_USING_CMSIS_DSP
+        rt_free(eq->inst);
+        eq->inst = rt_malloc(sizeof(union eq_inst) * channels);
+        if (eq->inst == RT_NULL)
+        {
+            wavpool_free(eq->state);
+            eq->state = RT_NULL;
+        }
+#endif
+        if (eq->state == RT_NULL)
+        {
+            eq->channels = 0;
+            return -RT_ENOMEM;
+        }
+        eq->channels = channels;
+    }
+    rt_memset(eq->state, 0, size * channels);
+
+#ifdef PKG_WP_USING_CMSIS_DSP
+    for (i = 0; i < channels; i++)
+    {
+        if (eq->format == WAVDSP_EQ_Q31)
+            arm_biquad_cascade_df1_init_q31(&eq->inst[i].q31, eq->sections, eq->coeff_q31,
+                                            eq->state + i * eq->sections * EQ_STATE_SIZE, eq->shift);
+        else
+            arm_biquad_cascade_df2T_init_f32(&eq->inst[i].f32, eq->sections, eq->coeff_f32,
+                                             (float *)(eq->state + i * eq->sections * EQ_STATE_SIZE));
+    }
+#else
+    (void)i;
+#endif
+
+    /* bands are designed for the samplerate of the stream */
+    eq->dirty = RT_TRUE;
+    eq_update(eq);
+
+    return RT_EOK;
+}
+
+static void eq_process(struct wavdsp_stage *stage, rt_int32_t *data, rt_size_t frames)
+{
+    struct wavdsp_eq *eq = (struct wavdsp_eq *)stage;
+    int channels = eq->channels, c;
+    rt_size_t n, i;
+    rt_int32_t *state;
+
+    eq_update(eq);
+    if (eq->active == RT_FALSE)
+        return;
+
+    while (frames > 0)
+    {
+        n = frames < EQ_CHUNK ? frames : EQ_CHUNK;
+
+#if defined(__ARM_NEON) && !defined(PKG_WP_USING_CMSIS_DSP)
+        if (eq->format == WAVDSP_EQ_F32 && channels == 2)
+        {
+            for (i = 0; i < n * 2; i++)
+                eq->scratch.f32[i] = (float)data[i];
+            eq_tdf2_f32_stereo(eq->coeff_f32, (float *)eq->state,
+                               (float *)(eq->state + eq->sections * EQ_STATE_SIZE),
+                               eq->sections, eq->scratch.f32, n);
+            for (i = 0; i < n * 2; i++)
+                data[i] = dsp_from_float(eq->scratch.f32[i]);
+
+            data += n * 2;
+            frames -= n;
+            continue;
+        }
+#endif
+
+        for (c = 0; c < channels; c++)
+        {
+            state = eq->state + c * eq->sections * EQ_STATE_SIZE;
+
+            if (eq->format == WAVDSP_EQ_Q31)
+            {
+                for (i = 0; i < n; i++)
+                    eq->scratch.q31[i] = dsp_clamp(data[i * channels + c]) << (16 - EQ_HEADROOM);
+#ifdef PKG_WP_USING_CMSIS_DSP
+                arm_biquad_cascade_df1_q31(&eq->inst[c].q31, eq->scratch.q31, eq->scratch.q31, n);
+#else
+                eq_df1_q31(eq->coeff_q31, state, eq->sections, eq->shift, eq->scratch.q31, n);
+#endif
+                for (i = 0; i < n; i++)
+                    data[i * channels + c] = dsp_clamp(((eq->scratch.q31[i] >> (15 - EQ_HEADROOM)) + 1) >> 1);
+            }
+            else
+            {
+                for (i = 0; i < n; i++)
+                    eq->scratch.f32[i] = (float)data[i * channels + c];
+#ifdef PKG_WP_USING_CMSIS_DSP
+                arm_biquad_cascade_df2T_f32(&eq->inst[c].f32, eq->scratch.f32, eq->scratch.f32, n);
+#else
+                eq_tdf2_f32(eq->coeff_f32, (float *)state, eq->sections, eq->scratch.f32, n);
+#endif
+                for (i = 0; i < n; i++)
+                    data[i * channels + c] = dsp_from_float(eq->scratch.f32[i]);
+            }
+        }
+
+        data += n * channels;
+        frames -= n;
+    }
+
+    (void)state;
+}
+
+static void eq_destroy(struct wavdsp_stage *stage)
+{
+    struct wavdsp_eq *eq = (struct wavdsp_eq *)stage;
+
+    wavpool_free(eq->state);
+#ifdef PKG_WP_USING_CMSIS_DSP
+    rt_free(eq->inst);
+#endif
+    rt_free(eq);
+}
+
+static const struct wavdsp_stage_ops eq_ops =
+{
+    eq_prepare,
+    eq_process,
+    RT_NULL,
+    eq_destroy,
+};
+
+struct wavdsp_stage *wavdsp_eq_create(int sections, int format)
+{
+    struct wavdsp_eq *eq;
+
+    if (sections <= 0 || sections > PKG_WP_EQ_SECTIONS_MAX ||
+        (format != WAVDSP_EQ_Q31 && format != WAVDSP_EQ_F32))
+        return RT_NULL;
+
+    eq = rt_malloc(sizeof(struct wavdsp_eq));
+    if (eq == RT_NULL)
+        return RT_NULL;
+    rt_memset(eq, 0, sizeof(struct wavdsp_eq));
+
+    eq->parent.ops = &eq_ops;
+    eq->parent.name = "eq";
+    eq->format = format;
+    eq->sections = sections;
+    eq->dirty = RT_TRUE;
+
+    return &eq->parent;
+}
+
+static rt_err_t eq_section_set(struct wavdsp_stage *stage, int index, const struct eq_section *section)
+{
+    struct wavdsp_eq *eq = (struct wavdsp_eq *)stage;
+
+    if (stage == RT_NULL || stage->ops != &eq_ops || index < 0 || index >= eq->sections)
+        return -RT_EINVAL;
+
+    rt_enter_critical();
+    eq->pending[index] = *section;
+    eq->dirty = RT_TRUE;
+    rt_exit_critical();
+
+    return RT_EOK;
+}
+
+rt_err_t wavdsp_eq_band_set(struct wavdsp_stage *stage, int index, const struct wavdsp_band *band)
+{
+    struct eq_section section;
+
+    rt_memset(&section, 0, sizeof(section));
+    section.mode = band->type == WAVDSP_BAND_OFF ? EQ_SECTION_OFF : EQ_SECTION_BAND;
+    section.band = *band;
+
+    return eq_section_set(stage, index, &section);
+}
+
+rt_err_t wavdsp_eq_coeff_set(struct wavdsp_stage *stage, int index, const struct wavdsp_biquad *coeff)
+{
+    struct eq_section section;
+
+    rt_memset(&section, 0, sizeof(section));
+    section.mode = EQ_SECTION_COEFF;
+    section.coeff = *coeff;
+
+    return eq_section_set(stage, index, &section);
+}
+
+#define LIMITER_SUBBLOCK     (32)           /* frames sharing one gain computation */
+#define LIMITER_UNITY        (1L << 16)     /* gain of 1 in q16 */
+
+#ifndef PKG_WP_LIMITER_LOOKAHEAD_MAX
+#define PKG_WP_LIMITER_LOOKAHEAD_MAX (16)   /* sub-blocks */
+#endif
+
+struct wavdsp_limiter
+{
+    struct wavdsp_stage parent;
+
+    /* written by the control threads, taken by the player thread at block boundaries */
+    struct wavdsp_dynamics pending;
+    volatile rt_bool_t dirty;
+
+    /* owned by the player thread */
+    struct wavdsp_dynamics params;
+    float ceiling;                          /* in sample units */
+    float makeup;
+    float release_coeff;
+    float attack_coeff;
+    float comp_release_coeff;
+    float envelope;                         /* gain of the compressor in dB */
+
+    int channels;
+    int lookahead;                          /* sub-blocks held in the delay */
+    rt_int32_t *delay;
+    rt_size_t delay_pos;                    /* frame of the delay ring */
+    rt_size_t phase;                        /* frames of the current sub-block */
+    rt_int32_t peak;                        /* of the incoming sub-block */
+    float wanted[PKG_WP_LIMITER_LOOKAHEAD_MAX]; /* gain wanted by the sub-blocks in the delay */
+    int wanted_pos;
+    float target;                           /* gain at the end of the outgoing sub-block */
+    rt_int32_t gain;                        /* q16 gain of the outgoing frame */
+    rt_int32_t step;                        /* q16 gain change per frame */
+
+    /* gain reduction metering in dB */
+    volatile float reduction;
+    volatile float reduction_max;
+};
+
+static const struct wavdsp_dynamics limiter_default =
+{
+    .ceiling      = -1.0f,
+    .lookahead    = 2.0f,
+    .release      = 50.0f,
+    .compressor   = 0,
+    .threshold    = -18.0f,
+    .ratio        = 4.0f,
+    .attack       = 5.0f,
+    .comp_release = 100.0f,
+    .makeup       = 0.0f,
+};
+
+/* one pole smoothing coefficient of a time constant, evaluated once per sub-block */
+static float limiter_coeff(float ms, rt_uint32_t samplerate)
+{
+    return 1.0f - expf(-(float)LIMITER_SUBBLOCK * 1000.0f / (ms * samplerate));
+}
+
+static void limiter_update(struct wavdsp_limiter *limiter)
+{
+    rt_uint32_t samplerate = limiter->parent.samplerate;
+
+    if (limiter->dirty == RT_FALSE)
+        return;
+
+    rt_enter_critical();
+    limiter->params = limiter->pending;
+    limiter->dirty = RT_FALSE;
+    rt_exit_critical();
+
+    limiter->ceiling = 32768.0f * powf(10.0f, limiter->params.ceiling / 20.0f);
+    limiter->makeup = limiter->params.compressor ? powf(10.0f, limiter->params.makeup / 20.0f) : 1.0f;
+    limiter->release_coeff = limiter_coeff(limiter->params.release, samplerate);
+    limiter->attack_coeff = limiter_coeff(limiter->params.attack, samplerate);
+    limiter->comp_release_coeff = limiter_coeff(limiter->params.comp_release, samplerate);
+}
+
+/* an incoming sub-block is complete, plan the gain of the next outgoing one */
+static void limiter_subblock(struct wavdsp_limiter *limiter)
+{
+    float level, wanted, lowest, target;
+    int i;
+
+    wanted = limiter->makeup;
+
+    /* feed forward compressor, the detector looks at the signal before the delay */
+    if (limiter->params.compressor)
+    {
+        level = limiter->peak > 0 ? 20.0f * log10f(limiter->peak / 32768.0f) : -120.0f;
+        level -= limiter->params.threshold;
+        level = level > 0.0f ? -level * (1.0f - 1.0f / limiter->params.ratio) : 0.0f;
+        if (level < limiter->envelope)
+            limiter->envelope += (level - limiter->envelope) * limiter->attack_coeff;
+        else
+            limiter->envelope += (level - limiter->envelope) * limiter->comp_release_coeff;
+        wanted *= powf(10.0f, limiter->envelope / 20.0f);
+    }
+
+    /* the peak must not pass the ceiling */
+    if (limiter->peak * wanted > limiter->ceiling)
+        wanted = limiter->ceiling / limiter->peak;
+    limiter->peak = 0;
+
+    limiter->wanted[limiter->wanted_pos] = wanted;
+    limiter->wanted_pos = (limiter->wanted_pos + 1) % limiter->lookahead;
+
+    /*
+     * the next outgoing sub-block is the oldest one of the window. Reaching the
+     * lowest gain of the window at its end keeps every later peak in the window
+     * below the ceiling as the gain ramps linearly within a sub-block.
+     */
+    lowest = limiter->wanted[0];
+    for (i = 1; i < limiter->lookahead; i++)
+    {
+        if (limiter->wanted[i] < lowest)
+            lowest = limiter->wanted[i];
+    }
+
+    if (lowest < limiter->target)
+        target = lowest;
+    else
+        target = limiter->target + (lowest - limiter->target) * limiter->release_coeff;
+
+    limiter->gain = (rt_int32_t)(limiter->target * LIMITER_UNITY);
+    limiter->step = ((rt_int32_t)(target * LIMITER_UNITY) - limiter->gain) / LIMITER_SUBBLOCK;
+    limiter->target = target;
+
+    level = target < 1.0f ? -20.0f * log10f(target) : 0.0f;
+    limiter->reduction = level;
+    if (level > limiter->reduction_max)
+        limiter->reduction_max = level;
+}
+
+static void limiter_reset(struct wavdsp_stage *stage)
+{
+    struct wavdsp_limiter *limiter = (struct wavdsp_limiter *)stage;
+    int i;
+
+    rt_memset(limiter->delay, 0, limiter->lookahead * LIMITER_SUBBLOCK * limiter->channels * sizeof(rt_int32_t));
+    for (i = 0; i < limiter->lookahead; i++)
+        limiter->wanted[i] = 1.0f;
+    limiter->wanted_pos = 0;
+    limiter->delay_pos = 0;
+    limiter->phase = 0;
+    limiter->peak = 0;
+    limiter->envelope = 0.0f;
+    limiter->target = 1.0f;
+    limiter->gain = LIMITER_UNITY;
+    limiter->step = 0;
+    limiter->reduction = 0.0f;
+}
+
+static rt_err_t limiter_prepare(struct wavdsp_stage *stage, rt_uint32_t samplerate, int channels)
+{
+    struct wavdsp_limiter *limiter = (struct wavdsp_limiter *)stage;
+    int lookahead;
+
+    limiter->dirty = RT_TRUE;
+    limiter_update(limiter);
+
+    /* at least two sub-blocks, the ramp down of a sub-block ends before the next one */
+    lookahead = (int)(limiter->params.lookahead * samplerate / 1000.0f + LIMITER_SUBBLOCK - 1) / LIMITER_SUBBLOCK;
+    if (lookahead < 2)
+        lookahead = 2;
+    if (lookahead > PKG_WP_LIMITER_LOOKAHEAD_MAX)
+        lookahead = PKG_WP_LIMITER_LOOKAHEAD_MAX;
+
+    if (limiter->lookahead != lookahead || limiter->channels != channels)
+    {
+        wavpool_free(limiter->delay);
+        limiter->delay = wavpool_malloc(lookahead * LIMITER_SUBBLOCK * channels * sizeof(rt_int32_t));
+        if (limiter->delay == RT_NULL)
+        {
+            limiter->lookahead = 0;
+            limiter->channels = 0;
+            return -RT_ENOMEM;
+        }
+        limiter->lookahead = lookahead;
+        limiter->channels = channels;
+    }
+
+    limiter_reset(stage);
+
+    return RT_EOK;
+}
+
+static void limiter_process(struct wavdsp_stage *stage, rt_int32_t *data, rt_size_t frames)
+{
+    struct wavdsp_limiter *limiter = (struct wavdsp_limiter *)stage;
+    rt_size_t delay_frames = limiter->lookahead * LIMITER_SUBBLOCK;
+    int channels = limiter->channels, c;
+    rt_int32_t *delay, x, peak = limiter->peak;
+
+    limiter_update(limiter);
+
+    while (frames--)
+    {
+        delay = limiter->delay + limiter->delay_pos * channels;
+        for (c = 0; c < channels; c++)
+        {
+            x = data[c];
+            if (x < 0 ? -x > peak : x > peak)
+                peak = x < 0 ? -x : x;
+            data[c] = dsp_clamp((rt_int32_t)(((rt_int64_t)delay[c] * limiter->gain) >> 16));
+            delay[c] = x;
+        }
+        data += channels;
+        limiter->gain += limiter->step;
+
+        if (++limiter->delay_pos == delay_frames)
+            limiter->delay_pos = 0;
+
+        if (++limiter->phase == LIMITER_SUBBLOCK)
+        {
+            limiter->phase = 0;
+            limiter->peak = peak;
+            limiter_subblock(limiter);
+            peak = 0;
+        }
+    }
+
+    limiter->peak = peak;
+}
+
+static void limiter_destroy(struct wavdsp_stage *stage)
+{
+    struct wavdsp_limiter *limiter = (struct wavdsp_limiter *)stage;
+
+    wavpool_free(limiter->delay);
+    rt_free(limiter);
+}
+
+static const struct wavdsp_stage_ops limiter_ops =
+{
+    limiter_prepare,
+    limiter_process,
+    limiter_reset,
+    limiter_destroy,
+};
+
+static rt_bool_t limiter_check(const struct wavdsp_dynamics *params)
+{
+    return params->ceiling <= 0.0f && params->lookahead > 0.0f && params->release > 0.0f &&
+           params->ratio >= 1.0f && params->attack > 0.0f && params->comp_release > 0.0f;
+}
+
+struct wavdsp_stage *wavdsp_limiter_create(const struct wavdsp_dynamics *params)
+{
+    struct wavdsp_limiter *limiter;
+
+    if (params == RT_NULL)
+        params = &limiter_default;
+    else if (!limiter_check(params))
+        return RT_NULL;
+
+    limiter = rt_malloc(sizeof(struct wavdsp_limiter));
+    if (limiter == RT_NULL)
+        return RT_NULL;
+    rt_memset(limiter, 0, sizeof(struct wavdsp_limiter));
+
+    limiter->parent.ops = &limiter_ops;
+    limiter->parent.name = "limiter";
+    limiter->pending = *params;
+    limiter->dirty = RT_TRUE;
+
+    return &limiter->parent;
+}
+
+rt_err_t wavdsp_limiter_set(struct wavdsp_stage *stage, const struct wavdsp_dynamics *params)
+{
+    struct wavdsp_limiter *limiter = (struct wavdsp_limiter *)stage;
+
+    if (stage == RT_NULL || stage->ops != &limiter_ops || params == RT_NULL || !limiter_check(params))
+        return -RT_EINVAL;
+
+    rt_enter_critical();
+    limiter->pending = *params;
+    limiter->dirty = RT_TRUE;
+    rt_exit_critical();
+
+    return RT_EOK;
+}
+
+rt_err_t wavdsp_limiter_reduction_get(struct wavdsp_stage *stage, float *reduction, float *reduction_max)
+{
+    struct wavdsp_limiter *limiter = (struct wavdsp_limiter *)stage;
+
+    if (stage == RT_NULL || stage->ops != &limiter_ops)
+        return -RT_EINVAL;
+
+    if (reduction)
+        *reduction = limiter->reduction;
+    if (reduction_max)
+    {
+        *reduction_max = limiter->reduction_max;
+        limiter->reduction_max = 0.0f;
+    }
+
+    return RT_EOK;
+}
@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <wavhdr.h>
+#include <wavpool.h>
+#include <wavduplex.h>
+
+#define DBG_TAG              "WAV_DUPLEX"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+#ifndef PKG_WP_DUPLEX_FRAMES
+#define PKG_WP_DUPLEX_FRAMES (256)
+#endif
+#ifndef PKG_WP_DUPLEX_STACK_SIZE
+#define PKG_WP_DUPLEX_STACK_SIZE (2048)
+#endif
+#ifndef PKG_WP_DUPLEX_PRIORITY
+#define PKG_WP_DUPLEX_PRIORITY (14)
+#endif
+
+/* impulse search of the latency measurement */
+#define LATENCY_LEAD_BLOCKS (8)
+#define LATENCY_THRESHOLD_MIN (512)
+
+enum DUPLEX_EVENT
+{
+    DUPLEX_EVENT_STOP  = 0x01,
+};
+
+struct duplex
+{
+    rt_device_t play_device;
+    rt_device_t record_device;
+    struct wavduplex_info info;
+    rt_uint16_t play_channels;
+    rt_uint16_t record_channels;            /* channels written to record_uri */
+    rt_int16_t *play_buffer;
+    rt_int16_t *record_buffer;
+    rt_int16_t *out_buffer;
+    FILE *play_fp;
+    FILE *record_fp;
+    rt_uint64_t timestamp;
+    rt_uint32_t record_length;
+    struct rt_event *event;
+    struct rt_completion ack;
+    rt_bool_t activated;
+};
+
+static struct duplex duplex;
+
+static void wavduplex_close(struct duplex *duplex)
+{
+    if (duplex->play_device)
+    {
+        rt_device_close(duplex->play_device);
+        duplex->play_device = RT_NULL;
+    }
+
+    if (duplex->record_device)
+    {
+        rt_device_close(duplex->record_device);
+        duplex->record_device = RT_NULL;
+    }
+
+    if (duplex->play_fp)
+    {
+        fclose(duplex->play_fp);
+        duplex->play_fp = RT_NULL;
+    }
+
+    if (duplex->record_fp)
+    {
+        fclose(duplex->record_fp);
+        duplex->record_fp = RT_NULL;
+    }
+
+    if (duplex->play_buffer)
+    {
+        wavpool_free(duplex->play_buffer);
+        duplex->play_buffer = RT_NULL;
+    }
+
+    if (duplex->record_buffer)
+    {
+        wavpool_free(duplex->record_buffer);
+        duplex->record_buffer = RT_NULL;
+    }
+
+    if (duplex->out_buffer)
+    {
+        wavpool_free(duplex->out_buffer);
+        duplex->out_buffer = RT_NULL;
+    }
+
+    if (duplex->event)
+    {
+        rt_event_delete(duplex->event);
+        duplex->event = RT_NULL;
+    }
+}
+
+static rt_err_t wavduplex_device_open(rt_device_t *device, const char *name, rt_uint16_t oflag,
+                                      int type, rt_uint32_t samplerate, rt_uint16_t channels)
+{
+    struct rt_audio_caps caps;
+    rt_device_t dev;
+
+    dev = rt_device_find(name);
+    if (dev == RT_NULL)
+    {
+        LOG_E("device %s not find", name);
+        return -RT_ERROR;
+    }
+
+    if (rt_device_open(dev, oflag) != RT_EOK)
+    {
+        LOG_E("open %s device faield", name);
+        return -RT_ERROR;
+    }
+
+    caps.main_type = type;
+    caps.sub_type  = AUDIO_DSP_PARAM;
+    caps.udata.config.samplerate = samplerate;
+    caps.udata.config.channels = channels;
+    caps.udata.config.samplebits = 16;
+    rt_device_control(dev, AUDIO_CTL_CONFIGURE, &caps);
+
+    *device = dev;
+
+    return RT_EOK;
+}
+
+/* open play and record devices with the same samplerate, buffers hold one block */
+static rt_err_t wavduplex_open(struct duplex *duplex)
+{
+    rt_err_t result;
+    rt_uint32_t samplerate = duplex->info.samplerate;
+
+    result = wavduplex_device_open(&duplex->play_device, PKG_WP_PLAY_DEVICE, RT_DEVICE_OFLAG_WRONLY,
+                                   AUDIO_TYPE_OUTPUT, samplerate, duplex->play_channels);
+    if (result != RT_EOK)
+        goto __exit;
+
+    result = wavduplex_device_open(&duplex->record_device, PKG_WP_RECORD_DEVICE, RT_DEVICE_OFLAG_RDONLY,
+                                   AUDIO_TYPE_INPUT, samplerate, duplex->info.channels);
+    if (result != RT_EOK)
+        goto __exit;
+
+    duplex->play_buffer = wavpool_malloc(PKG_WP_DUPLEX_FRAMES * duplex->play_channels * sizeof(rt_int16_t));
+    duplex->record_buffer = wavpool_malloc(PKG_WP_DUPLEX_FRAMES * duplex->info.channels * sizeof(rt_int16_t));
+    if (duplex->play_buffer == RT_NULL || duplex->record_buffer == RT_NULL)
+    {
+        LOG_E("malloc internal buffer for duplex failed");
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    duplex->timestamp = 0;
+    duplex->record_length = 0;
+
+    return RT_EOK;
+
+__exit:
+    wavduplex_close(duplex);
+
+    return result;
+}
+
+/* read a whole block, the record device may return less than asked */
+static void wavduplex_read(struct duplex *duplex)
+{
+    rt_size_t size = PKG_WP_DUPLEX_FRAMES * duplex->info.channels * sizeof(rt_int16_t);
+    rt_size_t offset = 0;
+    rt_ssize_t length;
+
+    while (offset < size)
+    {
+        length = rt_device_read(duplex->record_device, 0, (rt_uint8_t *)duplex->record_buffer + offset, size - offset);
+        if (length <= 0)
+        {
+            /* keep the frame clock, fill what the device didn't deliver */
+            rt_memset((rt_uint8_t *)duplex->record_buffer + offset, 0, size - offset);
+            break;
+        }
+        offset += length;
+    }
+}
+
+/* one block on the common clock: play it, capture the same number of frames */
+static void wavduplex_transfer(struct duplex *duplex)
+{
+    rt_size_t size = PKG_WP_DUPLEX_FRAMES * duplex->play_channels * sizeof(rt_int16_t);
+    rt_size_t length = 0;
+
+    if (duplex->play_fp)
+        length = fread(duplex->play_buffer, 1, size, duplex->play_fp);
+    /* play silence after the end of file */
+    if (length < size)
+        rt_memset((rt_uint8_t *)duplex->play_buffer + length, 0, size - length);
+
+    rt_device_write(duplex->play_device, 0, duplex->play_buffer, size);
+    wavduplex_read(duplex);
+}
+
+static void wavduplex_record_write(struct duplex *duplex)
+{
+    const rt_int16_t *play = duplex->play_buffer;
+    const rt_int16_t *record = duplex->record_buffer;
+    rt_int16_t *out = duplex->out_buffer;
+    rt_size_t n;
+    int c, pc = duplex->play_channels, rc = duplex->info.channels;
+    rt_int32_t sum;
+
+    if (!duplex->info.reference)
+    {
+        fwrite(record, PKG_WP_DUPLEX_FRAMES * rc * sizeof(rt_int16_t), 1, duplex->record_fp);
+        duplex->record_length += PKG_WP_DUPLEX_FRAMES * rc * sizeof(rt_int16_t);
+        return;
+    }
+
+    /* captured channels followed by the played frame downmixed to one channel */
+    for (n = 0; n < PKG_WP_DUPLEX_FRAMES; n++)
+    {
+        for (c = 0; c < rc; c++)
+            *out++ = *record++;
+
+        sum = 0;
+        for (c = 0; c < pc; c++)
+            sum += *play++;
+        *out++ = (rt_int16_t)(sum / pc);
+    }
+
+    fwrite(duplex->out_buffer, PKG_WP_DUPLEX_FRAMES * (rc + 1) * sizeof(rt_int16_t), 1, duplex->record_fp);
+    duplex->record_length += PKG_WP_DUPLEX_FRAMES * (rc + 1) * sizeof(rt_int16_t);
+}
+
+static void wavduplex_entry(void *parameter)
+{
+    struct duplex *duplex = (struct duplex *)parameter;
+    struct wav_header wav = {0};
+    rt_uint32_t recv_evt;
+
+    while (1)
+    {
+        wavduplex_transfer(duplex);
+
+        if (duplex->info.callback)
+            duplex->info.callback(duplex->play_buffer, duplex->record_buffer,
+                                  PKG_WP_DUPLEX_FRAMES, duplex->timestamp, duplex->info.user_data);
+
+        if (duplex->record_fp)
+            wavduplex_record_write(duplex);
+
+        duplex->timestamp += PKG_WP_DUPLEX_FRAMES;
+
+        /* recive stop event */
+        if (rt_event_recv(duplex->event, DUPLEX_EVENT_STOP,
+                          RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                          RT_WAITING_NO, &recv_evt) == RT_EOK)
+            break;
+    }
+
+    /* re-write wav header */
+    if (duplex->record_fp)
+    {
+        wavheader_init(&wav, duplex->info.samplerate, duplex->record_channels, duplex->record_length);
+        fseek(duplex->record_fp, 0, SEEK_SET);
+        wavheader_write(&wav, duplex->record_fp);
+    }
+
+    LOG_I("duplex end, %d frames", (rt_uint32_t)duplex->timestamp);
+    wavduplex_close(duplex);
+
+    /* ack event */
+    duplex->activated = RT_FALSE;
+    rt_completion_done(&duplex->ack);
+}
+
+rt_err_t wavduplex_start(struct wavduplex_info *info)
+{
+    struct wav_header wav = {0};
+    rt_thread_t tid;
+    rt_err_t result;
+
+    if (duplex.activated == RT_TRUE)
+        return -RT_EBUSY;
+
+    if (info == RT_NULL || info->channels == 0 || info->samplerate == 0)
+        return -RT_EINVAL;
+
+    duplex.info = *info;
+    duplex.play_channels = info->channels;
+    duplex.record_channels = info->channels + (info->reference ? 1 : 0);
+
+    /* the reference is played at the session samplerate */
+    if (info->play_uri)
+    {
+        duplex.play_fp = fopen(info->play_uri, "rb");
+        if (duplex.play_fp == RT_NULL)
+        {
+            LOG_E("open file %s failed", info->play_uri);
+            return -RT_ERROR;
+        }
+
+        wavheader_read(&wav, duplex.play_fp);
+        if (wav.fmt_sample_rate != info->samplerate || wav.fmt_bit_per_sample != 16)
+        {
+            LOG_E("%s is %dHz %dbits, duplex needs %dHz 16bits", info->play_uri,
+                  wav.fmt_sample_rate, wav.fmt_bit_per_sample, info->samplerate);
+            result = -RT_EINVAL;
+            goto __exit;
+        }
+        duplex.play_channels = wav.fmt_channels;
+    }
+
+    if (info->record_uri)
+    {
+        duplex.record_fp = fopen(info->record_uri, "wb+");
+        if (duplex.record_fp == RT_NULL)
+        {
+            LOG_E("open file %s failed", info->record_uri);
+            result = -RT_ERROR;
+            goto __exit;
+        }
+
+        /* reserve the wavheader, its size depends on the channels, it is written again at the end */
+        wavheader_init(&wav, info->samplerate, duplex.record_channels, 0);
+        wavheader_write(&wav, duplex.record_fp);
+
+        if (info->reference)
+        {
+            duplex.out_buffer = wavpool_malloc(PKG_WP_DUPLEX_FRAMES * duplex.record_channels * sizeof(rt_int16_t));
+            if (duplex.out_buffer == RT_NULL)
+            {
+                result = -RT_ENOMEM;
+                goto __exit;
+            }
+        }
+    }
+
+    duplex.event = rt_event_create("wav_d", RT_IPC_FLAG_FIFO);
+    if (duplex.event == RT_NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    result = wavduplex_open(&duplex);
+    if (result != RT_EOK)
+        return result;
+
+    tid = rt_thread_create("wav_d", wavduplex_entry, &duplex,
+                           PKG_WP_DUPLEX_STACK_SIZE, PKG_WP_DUPLEX_PRIORITY, 10);
+    if (tid == RT_NULL)
+    {
+        result = -RT_ENOMEM;
+        goto __exit;
+    }
+
+    LOG_I("duplex start, play %s, record %s", info->play_uri ? info->play_uri : "silence",
+          info->record_uri ? info->record_uri : "none");
+
+    /* the uris are only used while opening */
+    duplex.info.play_uri = RT_NULL;
+    duplex.info.record_uri = RT_NULL;
+    duplex.activated = RT_TRUE;
+    rt_thread_startup(tid);
+
+    return RT_EOK;
+
+__exit:
+    wavduplex_close(&duplex);
+
+    return result;
+}
+
+rt_err_t wavduplex_stop(void)
+{
+    if (duplex.activated == RT_TRUE)
+    {
+        rt_completion_init(&duplex.ack);
+        rt_event_send(duplex.event, DUPLEX_EVENT_STOP);
+        rt_completion_wait(&duplex.ack, RT_WAITING_FOREVER);
+    }
+
+    return RT_EOK;
+}
+
+rt_bool_t wavduplex_is_actived(void)
+{
+    return duplex.activated;
+}
+
+static int wavduplex_peak(const rt_int16_t *buffer, rt_size_t count)
+{
+    rt_size_t n;
+    int value, peak = 0;
+
+    for (n = 0; n < count; n++)
+    {
+        value = buffer[n] < 0 ? -buffer[n] : buffer[n];
+        if (value > peak)
+            peak = value;
+    }
+
+    return peak;
+}
+
+/* index of the first sample reaching the threshold */
+static rt_bool_t wavduplex_onset(const rt_int16_t *buffer, rt_size_t count, int threshold, rt_size_t *index)
+{
+    rt_size_t n;
+
+    for (n = 0; n < count; n++)
+    {
+        if (buffer[n] >= threshold || buffer[n] <= -threshold)
+        {
+            *index = n;
+            return RT_TRUE;
+        }
+    }
+
+    return RT_FALSE;
+}
+
+rt_err_t wavduplex_latency_measure(rt_uint32_t samplerate, rt_uint32_t *latency)
+{
+    struct duplex *measure;
+    rt_uint32_t block, blocks;
+    rt_uint64_t impulse;
+    rt_size_t index = 0;
+    int noise = 0, threshold, peak;
+    rt_err_t result;
+
+    if (latency == RT_NULL || samplerate == 0)
+        return -RT_EINVAL;
+
+    if (duplex.activated == RT_TRUE)
+        return -RT_EBUSY;
+
+    measure = rt_malloc(sizeof(struct duplex));
+    if (measure == RT_NULL)
+        return -RT_ENOMEM;
+    rt_memset(measure, 0, sizeof(struct duplex));
+
+    measure->info.samplerate = samplerate;
+    measure->info.channels = 1;
+    measure->play_channels = 1;
+
+    result = wavduplex_open(measure);
+    if (result != RT_EOK)
+    {
+        rt_free(measure);
+        return result;
+    }
+
+    /* learn the noise floor with silence, then one full scale sample */
+    for (block = 0; block < LATENCY_LEAD_BLOCKS; block++)
+    {
+        wavduplex_transfer(measure);
+        peak = wavduplex_peak(measure->record_buffer, PKG_WP_DUPLEX_FRAMES);
+        if (peak > noise)
+            noise = peak;
+        measure->timestamp += PKG_WP_DUPLEX_FRAMES;
+    }
+    threshold = noise * 4 > LATENCY_THRESHOLD_MIN ? noise * 4 : LATENCY_THRESHOLD_MIN;
+
+    impulse = measure->timestamp;
+    blocks = samplerate / PKG_WP_DUPLEX_FRAMES + 1;
+    result = -RT_ETIMEOUT;
+    for (block = 0; block < blocks; block++)
+    {
+        rt_memset(measure->play_buffer, 0, PKG_WP_DUPLEX_FRAMES * sizeof(rt_int16_t));
+        if (block == 0)
+            measure->play_buffer[0] = 32767;
+
+        rt_device_write(measure->play_device, 0, measure->play_buffer, PKG_WP_DUPLEX_FRAMES * sizeof(rt_int16_t));
+        wavduplex_read(measure);
+
+        if (wavduplex_onset(measure->record_buffer, PKG_WP_DUPLEX_FRAMES, threshold, &index))
+        {
+            *latency = (rt_uint32_t)(measure->timestamp + index - impulse);
+            result = RT_EOK;
+            break;
+        }
+        measure->timestamp += PKG_WP_DUPLEX_FRAMES;
+    }
+
+    wavduplex_close(measure);
+    rt_free(measure);
+
+    if (result == RT_EOK)
+        LOG_I("round trip latency %d frames, noise %d", *latency, noise);
+
+    return result;
+}
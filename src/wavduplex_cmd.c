@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <rtdevice.h>
+#include <optparse.h>
+#include <wavduplex.h>
+
+#include <stdlib.h>
+
+enum WAVDUPLEX_ACTTION
+{
+    WAVDUPLEX_ACTION_HELP    = 0,
+    WAVDUPLEX_ACTION_START   = 1,
+    WAVDUPLEX_ACTION_STOP    = 2,
+    WAVDUPLEX_ACTION_LATENCY = 3,
+};
+
+struct wavduplex_args
+{
+    int action;
+    struct wavduplex_info info;
+};
+
+static struct optparse_long opts[] =
+{
+    {"help", 'h', OPTPARSE_NONE    },       /* 帮助 */
+    {"start", 's', OPTPARSE_REQUIRED},      /* 开始 */
+    {"stop", 't', OPTPARSE_NONE    },       /* 停止 */
+    {"reference", 'r', OPTPARSE_NONE    },  /* 录制参考声道 */
+    {"latency", 'l', OPTPARSE_OPTIONAL},    /* 测量延迟 */
+    { NULL,  0,  OPTPARSE_NONE    }
+};
+
+static void usage(void)
+{
+    rt_kprintf("usage: wavduplex [option] [target] ...\n\n");
+    rt_kprintf("usage options:\n");
+    rt_kprintf("  -h,     --help                        Print defined help message.\n");
+    rt_kprintf("  -s play --start=play <record> <samplerate> <channels>\n");
+    rt_kprintf("                                        play and record on a common clock.\n");
+    rt_kprintf("  -r,     --reference                   Record the played reference as an extra channel.\n");
+    rt_kprintf("  -t,     --stop                        Stop play and record.\n");
+    rt_kprintf("  -l,     --latency[=samplerate]        Measure round trip latency in frames.\n");
+}
+
+static int wavduplex_args_prase(int argc, char *argv[], struct wavduplex_args *args)
+{
+    int ch;
+    int option_index;
+    struct optparse options;
+    rt_err_t result = RT_EOK;
+
+    if (argc == 1)
+    {
+        args->action = WAVDUPLEX_ACTION_HELP;
+        return RT_EOK;
+    }
+
+    /* Parse cmd */
+    optparse_init(&options, argv);
+    while ((ch = optparse_long(&options, opts, &option_index)) != -1)
+    {
+        switch (ch)
+        {
+        case 'h':
+            args->action = WAVDUPLEX_ACTION_HELP;
+            break;
+
+        case 's':
+            args->action = WAVDUPLEX_ACTION_START;
+            args->info.play_uri = options.optarg;
+            args->info.record_uri = ((argc <= 3) ? RT_NULL : argv[3]);
+            args->info.samplerate = ((argc <= 4) ? 16000 : atoi(argv[4]));
+            args->info.channels = ((argc <= 5) ? 1 : atoi(argv[5]));
+            break;
+
+        case 'r':
+            args->info.reference = RT_TRUE;
+            break;
+
+        case 't':
+            args->action = WAVDUPLEX_ACTION_STOP;
+            break;
+
+        case 'l':
+            args->action = WAVDUPLEX_ACTION_LATENCY;
+            args->info.samplerate = ((options.optarg == RT_NULL) ? 16000 : atoi(options.optarg));
+            break;
+
+        default:
+            result = -RT_EINVAL;
+            break;
+        }
+    }
+
+    return result;
+}
+
+int wav_duplex(int argc, char *argv[])
+{
+    int result = RT_EOK;
+    rt_uint32_t latency;
+    struct wavduplex_args args = {0};
+
+    result = wavduplex_args_prase(argc, argv, &args);
+    if (result != RT_EOK)
+    {
+        usage();
+        return result;
+    }
+
+    switch (args.action)
+    {
+    case WAVDUPLEX_ACTION_HELP:
+        usage();
+        break;
+
+    case WAVDUPLEX_ACTION_START:
+        result = wavduplex_start(&args.info);
+        break;
+
+    case WAVDUPLEX_ACTION_STOP:
+        result = wavduplex_stop();
+        break;
+
+    case WAVDUPLEX_ACTION_LATENCY:
+        result = wavduplex_latency_measure(args.info.samplerate, &latency);
+        if (result == RT_EOK)
+            rt_kprintf("latency %d frames\n", latency);
+        else
+            rt_kprintf("measure latency failed %d\n", result);
+        break;
+
+    default:
+        result = -RT_ERROR;
+        break;
+    }
+
+    return result;
+}
+
+MSH_CMD_EXPORT_ALIAS(wav_duplex, wavduplex, play and record wav music on a common clock);
@@ -12,136 +12,298 @@
 #include <rtthread.h>
 
 /* read and write integer from file stream */
-static int get_int(FILE *fp)
-{
-    char *s;
-    int i;
-    s = (char *)&i;
-    size_t len = sizeof(int);
-    int n = 0;
-    for (; n < len; n++)
-    {
-        s[n] = getc(fp);
-    }
+static int get_int(struct wavio *io)
+{
+    int i = 0;
+
+    wavio_read(io, &i, sizeof(int));
+
     return i;
 }
 
-static int put_int(int i, FILE *fp)
+static int put_int(int i, struct wavio *io)
 {
-    char *s;
-    s = (char *)&i;
-    size_t len = sizeof(int);
-    int n = 0;
-    for (; n < len; n++)
-    {
-        putc(s[n], fp);
-    }
+    wavio_write(io, &i, sizeof(int));
 
     return i;
 }
 
-static short int get_sint(FILE *fp)
+static rt_uint64_t get_u64(struct wavio *io)
 {
-    char *s;
-    short int i;
-    s = (char *)&i;
-    size_t len = sizeof(short);
-    int n = 0;
-    for (; n < len; n++)
-    {
-        s[n] = getc(fp);
-    }
+    rt_uint64_t i = 0;
+
+    wavio_read(io, &i, sizeof(rt_uint64_t));
 
     return i;
 }
 
-static short int put_sint(short int i, FILE *fp)
+static rt_uint64_t put_u64(rt_uint64_t i, struct wavio *io)
 {
-    char *s;
-    s = (char *)&i;
-    size_t len = sizeof(short);
-    int n = 0;
-    for (; n < len; n++)
-    {
-        putc(s[n], fp);
-    };
+    wavio_write(io, &i, sizeof(rt_uint64_t));
+
+    return i;
+}
+
+static short int get_sint(struct wavio *io)
+{
+    short int i = 0;
+
+    wavio_read(io, &i, sizeof(short));
+
+    return i;
+}
+
+static short int put_sint(short int i, struct wavio *io)
+{
+    wavio_write(io, &i, sizeof(short));
 
     return i;
 }
 
+/* tail of the KSDATAFORMAT_SUBTYPE guids after the format code */
+static const char subformat_guid[14] =
+{
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71
+};
+
 int wavheader_init(struct wav_header *header, int sample_rate, int channels, int datasize)
 {
-    if (header == NULL)
+    return wavheader_init_format(header, sample_rate, channels, 16, 16, WAVE_FORMAT_PCM, datasize);
+}
+
+int wavheader_init_format(struct wav_header *header, int sample_rate, int channels,
+                          int samplebits, int validbits, int format, int datasize)
+{
+    if (header == NULL || samplebits % 8 != 0 || validbits > samplebits)
         return -1;
 
-    rt_memcpy(header->riff_id, "RIFF", 4);
-    header->riff_datasize = datasize + 44 - 8;
+    rt_memset(header, 0, sizeof(struct wav_header));
 
+    rt_memcpy(header->riff_id, "RIFF", 4);
     rt_memcpy(header->riff_type, "WAVE", 4);
 
     rt_memcpy(header->fmt_id, "fmt ", 4);
-    header->fmt_datasize = 16;
-    header->fmt_compression_code = 1;
     header->fmt_channels = channels;
     header->fmt_sample_rate = sample_rate;
-    header->fmt_bit_per_sample = 16;
+    header->fmt_bit_per_sample = samplebits;
     header->fmt_avg_bytes_per_sec = header->fmt_sample_rate * header->fmt_channels * header->fmt_bit_per_sample / 8;
     header->fmt_block_align = header->fmt_bit_per_sample * header->fmt_channels / 8;
+    header->fmt_valid_bits = validbits;
+    header->fmt_sub_format = format;
+
+    if (samplebits > 16 || validbits != samplebits || channels > 2)
+    {
+        header->fmt_datasize = 40;
+        header->fmt_compression_code = (short)WAVE_FORMAT_EXTENSIBLE;
+        header->fmt_ext_size = 22;
+        header->fmt_channel_mask = channels == 1 ? 0x4 : (channels == 2 ? 0x3 : 0);
+    }
+    else
+    {
+        header->fmt_datasize = 16;
+        header->fmt_compression_code = format;
+    }
 
     rt_memcpy(header->data_id, "data", 4);
     header->data_datasize = datasize;
+    header->riff_datasize = datasize + wavheader_size(header) - 8;
+    header->datasize = header->data_datasize;
 
     return 0;
 }
 
-int wavheader_read(struct wav_header *header, FILE *fp)
+/* ds64 chunk of EBU Tech 3306 without a table, its header and three 64 bits sizes and the table length */
+#define DS64_CHUNK_SIZE (28)
+
+void wavheader_ds64_reserve(struct wav_header *header)
 {
-    if (fp == NULL)
+    if (header->ds64_id[0] != 0)
+        return;
+
+    rt_memcpy(header->ds64_id, "JUNK", 4);
+    header->riff_datasize += 8 + DS64_CHUNK_SIZE;
+}
+
+int wavheader_datasize_set(struct wav_header *header, rt_uint64_t datasize)
+{
+    rt_uint64_t riff_size = datasize + wavheader_size(header) - 8;
+
+    header->datasize = datasize;
+
+    /* the largest 32 bits size marks RF64, it can't be used as a size */
+    if (riff_size < WAVHDR_SIZE_RF64)
+    {
+        rt_memcpy(header->riff_id, "RIFF", 4);
+        if (header->ds64_id[0] != 0)
+            rt_memcpy(header->ds64_id, "JUNK", 4);
+        header->riff_datasize = (unsigned int)riff_size;
+        header->data_datasize = (unsigned int)datasize;
+        return 0;
+    }
+
+    header->riff_datasize = WAVHDR_SIZE_RF64;
+    header->data_datasize = WAVHDR_SIZE_RF64;
+    if (header->ds64_id[0] == 0)
         return -1;
 
-    fread(header->riff_id, 4, 1, fp);
-    header->riff_datasize = get_int(fp);
-    fread(header->riff_type, 4, 1, fp);
-    fread(header->fmt_id, 4, 1, fp);
-    header->fmt_datasize = get_int(fp);
-    header->fmt_compression_code = get_sint(fp);
-    header->fmt_channels = get_sint(fp);
-    header->fmt_sample_rate = get_int(fp);
-    header->fmt_avg_bytes_per_sec = get_int(fp);
-    header->fmt_block_align = get_sint(fp);
-    header->fmt_bit_per_sample = get_sint(fp);
-    fread(header->data_id, 4, 1, fp);
-    header->data_datasize = get_int(fp);
+    rt_memcpy(header->riff_id, "RF64", 4);
+    rt_memcpy(header->ds64_id, "ds64", 4);
+    header->ds64_riff_size = riff_size;
+    header->ds64_data_size = datasize;
+    header->ds64_sample_count = header->fmt_block_align ? datasize / header->fmt_block_align : 0;
 
     return 0;
 }
 
-int wavheader_write(struct wav_header *header, FILE *fp)
+int wavheader_size(struct wav_header *header)
 {
-    if (fp == NULL)
+    /* riff header, ds64 or its room, fmt chunk and data chunk header */
+    return 12 + (header->ds64_id[0] ? 8 + DS64_CHUNK_SIZE : 0) + 8 + header->fmt_datasize + 8;
+}
+
+int wavheader_io_read(struct wav_header *header, struct wavio *io)
+{
+    char id[4];
+    unsigned int size;
+    int fmt = 0;
+
+    if (io == NULL)
+        return -1;
+
+    rt_memset(header, 0, sizeof(struct wav_header));
+
+    wavio_read(io, header->riff_id, 4);
+    header->riff_datasize = get_int(io);
+    wavio_read(io, header->riff_type, 4);
+    if ((rt_memcmp(header->riff_id, "RIFF", 4) != 0 && rt_memcmp(header->riff_id, "RF64", 4) != 0) ||
+        rt_memcmp(header->riff_type, "WAVE", 4) != 0)
+        return -1;
+
+    /* walk the chunks until "data", the chunks before it can be in any order */
+    while (wavio_read(io, id, 4) == 4)
+    {
+        size = get_int(io);
+
+        if (rt_memcmp(id, "ds64", 4) == 0 && size >= 24)
+        {
+            rt_memcpy(header->ds64_id, id, 4);
+            header->ds64_riff_size = get_u64(io);
+            header->ds64_data_size = get_u64(io);
+            header->ds64_sample_count = get_u64(io);
+            size -= 24;
+        }
+        else if (rt_memcmp(id, "fmt ", 4) == 0 && size >= 16)
+        {
+            rt_memcpy(header->fmt_id, id, 4);
+            header->fmt_datasize = size;
+            header->fmt_compression_code = get_sint(io);
+            header->fmt_channels = get_sint(io);
+            header->fmt_sample_rate = get_int(io);
+            header->fmt_avg_bytes_per_sec = get_int(io);
+            header->fmt_block_align = get_sint(io);
+            header->fmt_bit_per_sample = get_sint(io);
+            size -= 16;
+
+            if ((unsigned short)header->fmt_compression_code == WAVE_FORMAT_EXTENSIBLE && size >= 24)
+            {
+                header->fmt_ext_size = get_sint(io);
+                header->fmt_valid_bits = get_sint(io);
+                header->fmt_channel_mask = get_int(io);
+                header->fmt_sub_format = get_sint(io);
+                size -= 10;
+            }
+            else
+            {
+                header->fmt_valid_bits = header->fmt_bit_per_sample;
+                header->fmt_sub_format = header->fmt_compression_code;
+            }
+            fmt = 1;
+        }
+        else if (rt_memcmp(id, "data", 4) == 0)
+        {
+            rt_memcpy(header->data_id, id, 4);
+            header->data_datasize = size;
+            if (size == WAVHDR_SIZE_RF64 && rt_memcmp(header->ds64_id, "ds64", 4) == 0)
+                header->datasize = header->ds64_data_size;
+            else
+                header->datasize = size;
+            return fmt ? 0 : -1;
+        }
+
+        /* chunks are padded to an even size */
+        if (wavio_seek(io, size + (size & 1), SEEK_CUR) < 0)
+            break;
+    }
+
+    return -1;
+}
+
+int wavheader_io_write(struct wav_header *header, struct wavio *io)
+{
+    if (io == NULL)
         return -1;
 
-    fwrite(header->riff_id, 4, 1, fp);
-    put_int(header->riff_datasize, fp);
-    fwrite(header->riff_type, 4, 1, fp);
-    fwrite(header->fmt_id, 4, 1, fp);
-    put_int(header->fmt_datasize, fp);
-    put_sint(header->fmt_compression_code, fp);
-    put_sint(header->fmt_channels, fp);
-    put_int(header->fmt_sample_rate, fp);
-    put_int(header->fmt_avg_bytes_per_sec, fp);
-    put_sint(header->fmt_block_align, fp);
-    put_sint(header->fmt_bit_per_sample, fp);
-    fwrite(header->data_id, 4, 1, fp);
-    put_int(header->data_datasize, fp);
+    wavio_write(io, header->riff_id, 4);
+    put_int(header->riff_datasize, io);
+    wavio_write(io, header->riff_type, 4);
+    if (header->ds64_id[0] != 0)
+    {
+        /* a JUNK chunk carries the same bytes, they are ignored until it becomes ds64 */
+        wavio_write(io, header->ds64_id, 4);
+        put_int(DS64_CHUNK_SIZE, io);
+        put_u64(header->ds64_riff_size, io);
+        put_u64(header->ds64_data_size, io);
+        put_u64(header->ds64_sample_count, io);
+        put_int(0, io);
+    }
+    wavio_write(io, header->fmt_id, 4);
+    put_int(header->fmt_datasize, io);
+    put_sint(header->fmt_compression_code, io);
+    put_sint(header->fmt_channels, io);
+    put_int(header->fmt_sample_rate, io);
+    put_int(header->fmt_avg_bytes_per_sec, io);
+    put_sint(header->fmt_block_align, io);
+    put_sint(header->fmt_bit_per_sample, io);
+    if (header->fmt_datasize == 40)
+    {
+        put_sint(header->fmt_ext_size, io);
+        put_sint(header->fmt_valid_bits, io);
+        put_int(header->fmt_channel_mask, io);
+        put_sint(header->fmt_sub_format, io);
+        wavio_write(io, subformat_guid, sizeof(subformat_guid));
+    }
+    wavio_write(io, header->data_id, 4);
+    put_int(header->data_datasize, io);
 
     return 0;
 }
 
+int wavheader_read(struct wav_header *header, FILE *fp)
+{
+    struct wavio io;
+
+    if (fp == NULL)
+        return -1;
+    wavio_attach(&io, fp);
+
+    return wavheader_io_read(header, &io);
+}
+
+int wavheader_write(struct wav_header *header, FILE *fp)
+{
+    struct wavio io;
+
+    if (fp == NULL)
+        return -1;
+    wavio_attach(&io, fp);
+
+    return wavheader_io_write(header, &io);
+}
+
 void wavheader_print(struct wav_header *header)
 {
     rt_kprintf("header.riff_id: %c%c%c%c\n", header->riff_id[0], header->riff_id[1], header->riff_id[2], header->riff_id[3]);
-    rt_kprintf("header.riff_datasize: %d\n", header->riff_datasize);
+    rt_kprintf("header.riff_datasize: %u\n", header->riff_datasize);
     rt_kprintf("header.riff_type: %c%c%c%c\n", header->riff_type[0], header->riff_type[1], header->riff_type[2], header->riff_type[3]);
     rt_kprintf("header.fmt_id: %c%c%c%c\n", header->fmt_id[0], header->fmt_id[1], header->fmt_id[2], header->fmt_id[3]);
     rt_kprintf("header.fmt_datasize: %d\n", header->fmt_datasize);
@@ -152,5 +314,10 @@ void wavheader_print(struct wav_header *header)
     rt_kprintf("header.fmt_block_align: %hd\n", header->fmt_block_align);
     rt_kprintf("header.fmt_bit_per_sample: %hd\n", header->fmt_bit_per_sample);
     rt_kprintf("header.data_id: %c%c%c%c\n", header->data_id[0], header->data_id[1], header->data_id[2], header->data_id[3]);
-    rt_kprintf("header.data_datasize: %d\n", header->data_datasize);
+    rt_kprintf("header.data_datasize: %u\n", header->data_datasize);
+    if (rt_memcmp(header->ds64_id, "ds64", 4) == 0)
+    {
+        rt_kprintf("header.ds64_riff_size: %u MB\n", (rt_uint32_t)(header->ds64_riff_size >> 20));
+        rt_kprintf("header.ds64_data_size: %u MB\n", (rt_uint32_t)(header->ds64_data_size >> 20));
+    }
 }
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavindex.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define DBG_TAG              "WAV_INDEX"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+#define INDEX_MAGIC          (0x58444957)   /* "WIDX" */
+#define INDEX_VERSION        (2)
+#define INDEX_NAME           "/.wavindex"
+
+/*
+ * The index file is a header followed by the entries sorted by name. Entries are
+ * stored in the memory layout of the target, the entry size in the header rejects
+ * a file written with another layout.
+ */
+struct wavindex_file_header
+{
+    rt_uint32_t magic;
+    rt_uint16_t version;
+    rt_uint16_t entry_size;
+    rt_uint32_t count;
+};
+
+struct wavindex
+{
+    struct wavindex_entry *entry;
+    int count;
+    int capacity;
+};
+
+static int wavindex_compare(const void *a, const void *b)
+{
+    return strcmp(((const struct wavindex_entry *)a)->name, ((const struct wavindex_entry *)b)->name);
+}
+
+static struct wavindex_entry *wavindex_find(struct wavindex_entry *entry, int count, const char *name)
+{
+    int low = 0, high = count - 1, mid, result;
+
+    while (low <= high)
+    {
+        mid = (low + high) / 2;
+        result = strcmp(name, entry[mid].name);
+        if (result == 0)
+            return &entry[mid];
+        if (result < 0)
+            high = mid - 1;
+        else
+            low = mid + 1;
+    }
+
+    return RT_NULL;
+}
+
+static struct wavindex_entry *wavindex_append(struct wavindex *index)
+{
+    struct wavindex_entry *entry;
+    int capacity;
+
+    if (index->count == index->capacity)
+    {
+        capacity = index->capacity ? index->capacity * 2 : 16;
+        entry = rt_realloc(index->entry, capacity * sizeof(struct wavindex_entry));
+        if (entry == RT_NULL)
+            return RT_NULL;
+        index->entry = entry;
+        index->capacity = capacity;
+    }
+
+    return &index->entry[index->count++];
+}
+
+/* previous entries, an index file that can't be used is the same as none */
+static void wavindex_load(struct wavindex *index, const char *path)
+{
+    struct wavindex_file_header header;
+    FILE *fp;
+
+    fp = fopen(path, "rb");
+    if (fp == RT_NULL)
+        return;
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != INDEX_MAGIC ||
+        header.version != INDEX_VERSION || header.entry_size != sizeof(struct wavindex_entry))
+    {
+        LOG_W("ignore index file %s", path);
+        goto __exit;
+    }
+
+    if (header.count == 0)
+        goto __exit;
+
+    index->entry = rt_malloc(header.count * sizeof(struct wavindex_entry));
+    if (index->entry == RT_NULL)
+        goto __exit;
+    index->capacity = header.count;
+
+    if (fread(index->entry, sizeof(struct wavindex_entry), header.count, fp) != header.count)
+    {
+        LOG_W("truncated index file %s", path);
+        goto __exit;
+    }
+    index->count = header.count;
+
+__exit:
+    fclose(fp);
+}
+
+static rt_err_t wavindex_save(struct wavindex *index, const char *path)
+{
+    struct wavindex_file_header header;
+    rt_err_t result = RT_EOK;
+    FILE *fp;
+
+    fp = fopen(path, "wb");
+    if (fp == RT_NULL)
+    {
+        LOG_E("open index file %s failed", path);
+        return -RT_ERROR;
+    }
+
+    header.magic = INDEX_MAGIC;
+    header.version = INDEX_VERSION;
+    header.entry_size = sizeof(struct wavindex_entry);
+    header.count = index->count;
+    if (fwrite(&header, sizeof(header), 1, fp) != 1 ||
+        (index->count && fwrite(index->entry, sizeof(struct wavindex_entry), index->count, fp) != index->count))
+    {
+        LOG_E("write index file %s failed", path);
+        result = -RT_ERROR;
+    }
+    fclose(fp);
+
+    return result;
+}
+
+static rt_bool_t wavindex_is_wav(const char *name)
+{
+    rt_size_t length = rt_strlen(name);
+    const char *ext = name + length - 4;
+
+    return length > 4 && ext[0] == '.' &&
+           (ext[1] == 'w' || ext[1] == 'W') && (ext[2] == 'a' || ext[2] == 'A') && (ext[3] == 'v' || ext[3] == 'V');
+}
+
+/* parse the header of a new or changed file */
+static rt_err_t wavindex_parse(struct wavindex_entry *entry, const char *path)
+{
+    FILE *fp;
+    long offset;
+
+    fp = fopen(path, "rb");
+    if (fp == RT_NULL)
+        return -RT_ERROR;
+
+    if (wavheader_read(&entry->header, fp) != 0)
+    {
+        fclose(fp);
+        return -RT_ERROR;
+    }
+    offset = ftell(fp);
+    fclose(fp);
+
+    entry->data_offset = offset;
+    /* files being recorded keep a zero or stale length until they are closed */
+    if (entry->header.datasize == 0 || entry->header.datasize > entry->file_size - entry->data_offset)
+        entry->header.datasize = entry->file_size - entry->data_offset;
+    /* sizes that don't fit in 32 bits are only in datasize, like RF64 keeps them */
+    if (entry->header.data_datasize != WAVHDR_SIZE_RF64)
+        entry->header.data_datasize = entry->header.datasize < WAVHDR_SIZE_RF64 ?
+                                      (unsigned int)entry->header.datasize : WAVHDR_SIZE_RF64;
+
+    return RT_EOK;
+}
+
+wavindex_t wavindex_open(const char *dir, const char *index_path)
+{
+    struct wavindex *index, old = {0};
+    struct wavindex_entry *entry, *cached;
+    struct dirent *dirent;
+    struct stat st;
+    rt_bool_t dirty = RT_FALSE;
+    char *index_name = RT_NULL, *path = RT_NULL;
+    rt_size_t dir_length;
+    DIR *dp = RT_NULL;
+
+    index = rt_malloc(sizeof(struct wavindex));
+    if (index == RT_NULL)
+        return RT_NULL;
+    rt_memset(index, 0, sizeof(struct wavindex));
+
+    dir_length = rt_strlen(dir);
+    path = rt_malloc(dir_length + 1 + PKG_WP_INDEX_NAME_MAX + sizeof(INDEX_NAME));
+    if (path == RT_NULL)
+        goto __failed;
+
+    if (index_path == RT_NULL)
+    {
+        index_name = rt_malloc(dir_length + sizeof(INDEX_NAME));
+        if (index_name == RT_NULL)
+            goto __failed;
+        rt_snprintf(index_name, dir_length + sizeof(INDEX_NAME), "%s%s", dir, INDEX_NAME);
+        index_path = index_name;
+    }
+
+    dp = opendir(dir);
+    if (dp == RT_NULL)
+    {
+        LOG_E("open directory %s failed", dir);
+        goto __failed;
+    }
+
+    wavindex_load(&old, index_path);
+
+    while ((dirent = readdir(dp)) != RT_NULL)
+    {
+        if (!wavindex_is_wav(dirent->d_name))
+            continue;
+
+        if (rt_strlen(dirent->d_name) >= PKG_WP_INDEX_NAME_MAX)
+        {
+            LOG_W("skip %s, name longer than %d", dirent->d_name, PKG_WP_INDEX_NAME_MAX - 1);
+            continue;
+        }
+
+        rt_snprintf(path, dir_length + 1 + PKG_WP_INDEX_NAME_MAX, "%s/%s", dir, dirent->d_name);
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+            continue;
+
+        entry = wavindex_append(index);
+        if (entry == RT_NULL)
+            goto __failed;
+
+        /* unchanged files are revalidated by mtime and size only */
+        cached = wavindex_find(old.entry, old.count, dirent->d_name);
+        if (cached && cached->mtime == (rt_uint32_t)st.st_mtime && cached->file_size == (rt_uint64_t)st.st_size)
+        {
+            *entry = *cached;
+            continue;
+        }
+
+        rt_memset(entry, 0, sizeof(struct wavindex_entry));
+        rt_strncpy(entry->name, dirent->d_name, PKG_WP_INDEX_NAME_MAX - 1);
+        entry->mtime = st.st_mtime;
+        entry->file_size = st.st_size;
+        if (wavindex_parse(entry, path) != RT_EOK)
+        {
+            LOG_W("skip %s, not a wav file", path);
+            index->count--;
+            continue;
+        }
+        dirty = RT_TRUE;
+    }
+
+    /* readdir order isn't sorted on every file system */
+    if (index->count > 1)
+        qsort(index->entry, index->count, sizeof(struct wavindex_entry), wavindex_compare);
+
+    /* removed files only show up as a different count */
+    if (dirty || index->count != old.count)
+        wavindex_save(index, index_path);
+
+    LOG_D("%s: %d files, %s", dir, index->count, dirty ? "updated" : "unchanged");
+
+    closedir(dp);
+    rt_free(old.entry);
+    rt_free(path);
+    if (index_name)
+        rt_free(index_name);
+
+    return index;
+
+__failed:
+    if (dp)
+        closedir(dp);
+    if (old.entry)
+        rt_free(old.entry);
+    if (path)
+        rt_free(path);
+    if (index_name)
+        rt_free(index_name);
+    wavindex_close(index);
+
+    return RT_NULL;
+}
+
+void wavindex_close(wavindex_t index)
+{
+    if (index == RT_NULL)
+        return;
+
+    if (index->entry)
+        rt_free(index->entry);
+    rt_free(index);
+}
+
+int wavindex_count(wavindex_t index)
+{
+    return index ? index->count : 0;
+}
+
+const struct wavindex_entry *wavindex_get(wavindex_t index, int position)
+{
+    if (index == RT_NULL || position < 0 || position >= index->count)
+        return RT_NULL;
+
+    return &index->entry[position];
+}
+
+const struct wavindex_entry *wavindex_lookup(wavindex_t index, const char *name, struct wav_header *header)
+{
+    struct wavindex_entry *entry;
+
+    if (index == RT_NULL || name == RT_NULL)
+        return RT_NULL;
+
+    entry = wavindex_find(index->entry, index->count, name);
+    if (entry && header)
+        *header = entry->header;
+
+    return entry;
+}
+
+rt_uint32_t wavindex_duration(const struct wavindex_entry *entry)
+{
+    rt_uint32_t bytes_per_sec = entry->header.fmt_avg_bytes_per_sec;
+
+    if (bytes_per_sec == 0)
+        return 0;
+
+    return (rt_uint32_t)(entry->header.datasize * 1000 / bytes_per_sec);
+}
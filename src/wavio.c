@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavio.h>
+#include <wavpool.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef PKG_WP_USING_IO_MMAP
+#include <sys/mman.h>
+#endif
+
+#define DBG_TAG              "WAV_IO"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+static const char *backend_name[WAVIO_BACKEND_MAX] =
+{
+    "stdio",
+    "fd",
+    "direct",
+    "mmap",
+};
+
+/* stdio */
+
+static rt_err_t stdio_open(struct wavio *io, const char *path, int mode)
+{
+    io->fp = fopen(path, mode == WAVIO_MODE_READ ? "rb" : "wb+");
+
+    return io->fp ? RT_EOK : -RT_ERROR;
+}
+
+static rt_ssize_t stdio_read(struct wavio *io, void *buffer, rt_size_t size, void **data)
+{
+    *data = buffer;
+
+    return fread(buffer, 1, size, io->fp);
+}
+
+static rt_ssize_t stdio_write(struct wavio *io, const void *buffer, rt_size_t size)
+{
+    return fwrite(buffer, 1, size, io->fp);
+}
+
+static rt_off_t stdio_seek(struct wavio *io, rt_off_t offset, int whence)
+{
+    if (fseek(io->fp, offset, whence) != 0)
+        return -RT_ERROR;
+
+    return ftell(io->fp);
+}
+
+static void stdio_close(struct wavio *io)
+{
+    if (io->fp && !io->attached)
+        fclose(io->fp);
+    io->fp = RT_NULL;
+}
+
+static const struct wavio_ops stdio_ops =
+{
+    stdio_open,
+    stdio_read,
+    stdio_write,
+    stdio_seek,
+    stdio_close,
+};
+
+/* file descriptor, the offset is moved lazily so reads in sequence don't seek */
+
+static rt_err_t fd_open(struct wavio *io, const char *path, int mode)
+{
+    if (mode == WAVIO_MODE_READ)
+        io->fd = open(path, O_RDONLY, 0);
+    else
+        io->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
+    if (io->fd < 0)
+        return -RT_ERROR;
+
+    io->pos = io->fd_pos = 0;
+
+    return RT_EOK;
+}
+
+static rt_err_t fd_sync(struct wavio *io)
+{
+    if (io->fd_pos != io->pos)
+    {
+        if (lseek(io->fd, io->pos, SEEK_SET) < 0)
+            return -RT_ERROR;
+        io->fd_pos = io->pos;
+    }
+
+    return RT_EOK;
+}
+
+static rt_ssize_t fd_read(struct wavio *io, void *buffer, rt_size_t size, void **data)
+{
+    rt_ssize_t length;
+
+    *data = buffer;
+    if (fd_sync(io) != RT_EOK)
+        return -RT_ERROR;
+
+    length = read(io->fd, buffer, size);
+    if (length > 0)
+        io->pos = io->fd_pos += length;
+
+    return length;
+}
+
+static rt_ssize_t fd_write(struct wavio *io, const void *buffer, rt_size_t size)
+{
+    rt_ssize_t length;
+
+    if (fd_sync(io) != RT_EOK)
+        return -RT_ERROR;
+
+    /* the sector held by direct reads may be overwritten */
+    io->sector_pos = -1;
+
+    length = write(io->fd, buffer, size);
+    if (length > 0)
+        io->pos = io->fd_pos += length;
+
+    return length;
+}
+
+static rt_off_t fd_seek(struct wavio *io, rt_off_t offset, int whence)
+{
+    rt_off_t pos;
+
+    if (whence == SEEK_END)
+    {
+        pos = lseek(io->fd, offset, SEEK_END);
+        if (pos < 0)
+            return -RT_ERROR;
+        io->fd_pos = pos;
+    }
+    else
+    {
+        pos = whence == SEEK_CUR ? io->pos + offset : offset;
+        if (pos < 0)
+            return -RT_ERROR;
+    }
+    io->pos = pos;
+
+    return pos;
+}
+
+static void fd_close(struct wavio *io)
+{
+    if (io->fd >= 0)
+        close(io->fd);
+    io->fd = -1;
+}
+
+static const struct wavio_ops fd_ops =
+{
+    fd_open,
+    fd_read,
+    fd_write,
+    fd_seek,
+    fd_close,
+};
+
+/*
+ * direct, the file system is only asked for whole sectors at sector aligned offsets, which
+ * it transfers straight to the buffer instead of through its own cache. The partial sector
+ * at the end of a read is kept, so the next read starts from it without touching the file.
+ */
+
+static rt_err_t direct_open(struct wavio *io, const char *path, int mode)
+{
+    io->sector = rt_malloc_align(PKG_WP_IO_SECTOR_SIZE, WAVPOOL_ALIGN);
+    if (io->sector == RT_NULL)
+        return -RT_ENOMEM;
+    io->sector_pos = -1;
+    io->sector_len = 0;
+
+    return fd_open(io, path, mode);
+}
+
+static rt_ssize_t direct_sector_load(struct wavio *io, rt_off_t sector)
+{
+    rt_ssize_t length;
+
+    if (io->sector_pos == sector)
+        return io->sector_len;
+
+    if (io->fd_pos != sector)
+    {
+        if (lseek(io->fd, sector, SEEK_SET) < 0)
+            return -RT_ERROR;
+        io->fd_pos = sector;
+    }
+
+    length = read(io->fd, io->sector, PKG_WP_IO_SECTOR_SIZE);
+    if (length < 0)
+    {
+        io->sector_pos = -1;
+        return -RT_ERROR;
+    }
+    io->fd_pos += length;
+    io->sector_pos = sector;
+    io->sector_len = length;
+
+    return length;
+}
+
+static rt_ssize_t direct_read(struct wavio *io, void *buffer, rt_size_t size, void **data)
+{
+    rt_uint8_t *dst = buffer;
+    rt_size_t total = 0, count;
+    rt_ssize_t length;
+    rt_off_t offset;
+
+    *data = buffer;
+    while (total < size)
+    {
+        offset = io->pos % PKG_WP_IO_SECTOR_SIZE;
+
+        if (offset == 0 && size - total >= PKG_WP_IO_SECTOR_SIZE)
+        {
+            /* whole sectors go straight to the caller */
+            count = (size - total) - (size - total) % PKG_WP_IO_SECTOR_SIZE;
+            if (fd_sync(io) != RT_EOK)
+                return total ? (rt_ssize_t)total : -RT_ERROR;
+
+            length = read(io->fd, dst + total, count);
+            if (length <= 0)
+                return total ? (rt_ssize_t)total : length;
+            io->pos = io->fd_pos += length;
+            total += length;
+            if ((rt_size_t)length < count)
+                break;
+        }
+        else
+        {
+            /* partial sector, taken from the sector held */
+            length = direct_sector_load(io, io->pos - offset);
+            if (length < 0)
+                return total ? (rt_ssize_t)total : length;
+            if (length <= offset)
+                break;
+
+            count = length - offset;
+            if (count > size - total)
+                count = size - total;
+            rt_memcpy(dst + total, io->sector + offset, count);
+            io->pos += count;
+            total += count;
+        }
+    }
+
+    return total;
+}
+
+static void direct_close(struct wavio *io)
+{
+    fd_close(io);
+    if (io->sector)
+        rt_free_align(io->sector);
+    io->sector = RT_NULL;
+}
+
+static const struct wavio_ops direct_ops =
+{
+    direct_open,
+    direct_read,
+    fd_write,
+    fd_seek,
+    direct_close,
+};
+
+#ifdef PKG_WP_USING_IO_MMAP
+/* mmap, reads hand out the mapped pages and the file system fills them on demand */
+
+static rt_err_t mmap_open(struct wavio *io, const char *path, int mode)
+{
+    struct stat st;
+    void *map;
+
+    if (mode != WAVIO_MODE_READ)
+        return -RT_ENOSYS;
+
+    io->fd = open(path, O_RDONLY, 0);
+    if (io->fd < 0)
+        return -RT_ERROR;
+
+    if (fstat(io->fd, &st) != 0 || st.st_size == 0)
+        goto __exit;
+
+    map = mmap(RT_NULL, st.st_size, PROT_READ, MAP_SHARED, io->fd, 0);
+    if (map == MAP_FAILED)
+        goto __exit;
+
+    io->map = map;
+    io->size = st.st_size;
+    io->pos = 0;
+
+    return RT_EOK;
+
+__exit:
+    close(io->fd);
+    io->fd = -1;
+
+    return -RT_ERROR;
+}
+
+static rt_ssize_t mmap_read(struct wavio *io, void *buffer, rt_size_t size, void **data)
+{
+    rt_size_t remain = io->pos < io->size ? io->size - io->pos : 0;
+
+    if (size > remain)
+        size = remain;
+    *data = io->map + io->pos;
+    io->pos += size;
+
+    return size;
+}
+
+static rt_ssize_t mmap_write(struct wavio *io, const void *buffer, rt_size_t size)
+{
+    return -RT_ENOSYS;
+}
+
+static rt_off_t mmap_seek(struct wavio *io, rt_off_t offset, int whence)
+{
+    rt_off_t pos;
+
+    if (whence == SEEK_SET)
+        pos = offset;
+    else if (whence == SEEK_CUR)
+        pos = io->pos + offset;
+    else
+        pos = io->size + offset;
+
+    if (pos < 0)
+        return -RT_ERROR;
+    io->pos = pos;
+
+    return pos;
+}
+
+static void mmap_close(struct wavio *io)
+{
+    if (io->map)
+        munmap(io->map, io->size);
+    io->map = RT_NULL;
+    fd_close(io);
+}
+
+static const struct wavio_ops mmap_ops =
+{
+    mmap_open,
+    mmap_read,
+    mmap_write,
+    mmap_seek,
+    mmap_close,
+};
+#endif /* PKG_WP_USING_IO_MMAP */
+
+rt_err_t wavio_open(struct wavio *io, const char *path, int mode, int backend)
+{
+    rt_err_t result;
+
+    RT_ASSERT(io != RT_NULL);
+    RT_ASSERT(path != RT_NULL);
+
+    rt_memset(io, 0, sizeof(struct wavio));
+    io->fd = -1;
+    io->backend = backend;
+
+    switch (backend)
+    {
+    case WAVIO_BACKEND_STDIO:
+        io->ops = &stdio_ops;
+        break;
+
+    case WAVIO_BACKEND_FD:
+        io->ops = &fd_ops;
+        break;
+
+    case WAVIO_BACKEND_DIRECT:
+        io->ops = &direct_ops;
+        break;
+
+#ifdef PKG_WP_USING_IO_MMAP
+    case WAVIO_BACKEND_MMAP:
+        io->ops = &mmap_ops;
+        break;
+#endif
+
+    default:
+        LOG_E("io backend %s isn't supported", wavio_backend_name(backend));
+        return -RT_ENOSYS;
+    }
+
+    result = io->ops->open(io, path, mode);
+    if (result != RT_EOK)
+    {
+        io->ops->close(io);
+        io->ops = RT_NULL;
+    }
+
+    return result;
+}
+
+void wavio_attach(struct wavio *io, FILE *fp)
+{
+    RT_ASSERT(io != RT_NULL);
+
+    rt_memset(io, 0, sizeof(struct wavio));
+    io->fd = -1;
+    io->backend = WAVIO_BACKEND_STDIO;
+    io->ops = &stdio_ops;
+    io->fp = fp;
+    io->attached = RT_TRUE;
+}
+
+rt_ssize_t wavio_read(struct wavio *io, void *buffer, rt_size_t size)
+{
+    rt_ssize_t length;
+    void *data;
+
+    length = io->ops->read(io, buffer, size, &data);
+    if (length > 0 && data != buffer)
+        rt_memcpy(buffer, data, length);
+
+    return length;
+}
+
+rt_ssize_t wavio_read_ref(struct wavio *io, void *buffer, rt_size_t size, void **data)
+{
+    return io->ops->read(io, buffer, size, data);
+}
+
+rt_ssize_t wavio_write(struct wavio *io, const void *buffer, rt_size_t size)
+{
+    return io->ops->write(io, buffer, size);
+}
+
+rt_off_t wavio_seek(struct wavio *io, rt_off_t offset, int whence)
+{
+    return io->ops->seek(io, offset, whence);
+}
+
+rt_off_t wavio_tell(struct wavio *io)
+{
+    return io->ops->seek(io, 0, SEEK_CUR);
+}
+
+void wavio_close(struct wavio *io)
+{
+    if (io->ops)
+        io->ops->close(io);
+    io->ops = RT_NULL;
+}
+
+const char *wavio_backend_name(int backend)
+{
+    if (backend < 0 || backend >= WAVIO_BACKEND_MAX)
+        return "unknown";
+
+    return backend_name[backend];
+}
+
+int wavio_backend_find(const char *name)
+{
+    int backend;
+
+    for (backend = 0; backend < WAVIO_BACKEND_MAX; backend++)
+    {
+        if (rt_strcmp(backend_name[backend], name) == 0)
+            return backend;
+    }
+
+    return -RT_ERROR;
+}
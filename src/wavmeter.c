@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <wavmeter.h>
+
+#if defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#endif
+
+/* orders the sequence against the level on multi core targets */
+#if defined(__GNUC__)
+#define METER_BARRIER() __sync_synchronize()
+#elif defined(__CC_ARM)
+#define METER_BARRIER() __dmb(0xF)
+#else
+#define METER_BARRIER()
+#endif
+
+static rt_uint16_t meter_sqrt(rt_uint32_t value)
+{
+    rt_uint32_t root = 0, bit = 1UL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (rt_uint16_t)root;
+}
+
+static void meter_reduce(const rt_int16_t *in, rt_size_t frames, int channels,
+                         rt_int32_t *peak, rt_uint64_t *energy)
+{
+    rt_size_t n;
+    rt_int32_t s;
+    int c;
+
+#if defined(__ARM_FEATURE_SIMD32)
+    /*
+     * even channel counts keep a channel pair in one word, the pair is reduced
+     * with dual 16 bits compare/select and the squares go to 64 bits accumulators.
+     */
+    if ((channels & 1) == 0 && ((rt_ubase_t)in & 3) == 0)
+    {
+        int words = channels / 2, k;
+        const rt_int32_t *w = (const rt_int32_t *)in;
+        int16x2_t hi[PKG_WP_METER_CHANNELS_MAX / 2], lo[PKG_WP_METER_CHANNELS_MAX / 2];
+        rt_int64_t acc[PKG_WP_METER_CHANNELS_MAX];
+
+        for (k = 0; k < words; k++)
+        {
+            hi[k] = (int16x2_t)0x80008000;
+            lo[k] = (int16x2_t)0x7FFF7FFF;
+            acc[2 * k] = 0;
+            acc[2 * k + 1] = 0;
+        }
+
+        for (n = 0; n < frames; n++)
+        {
+            for (k = 0; k < words; k++)
+            {
+                int16x2_t v = *w++;
+
+                (void)__ssub16(v, hi[k]);
+                hi[k] = __sel(v, hi[k]);
+                (void)__ssub16(lo[k], v);
+                lo[k] = __sel(v, lo[k]);
+                acc[2 * k] = __smlald(v, v & 0x0000FFFF, acc[2 * k]);
+                acc[2 * k + 1] = __smlald(v, v & (int16x2_t)0xFFFF0000, acc[2 * k + 1]);
+            }
+        }
+
+        for (k = 0; k < words; k++)
+        {
+            rt_int32_t max, min;
+
+            max = (rt_int16_t)(hi[k] & 0xFFFF);
+            min = (rt_int16_t)(lo[k] & 0xFFFF);
+            peak[2 * k] = max > -min ? max : -min;
+            max = (rt_int16_t)((rt_uint32_t)hi[k] >> 16);
+            min = (rt_int16_t)((rt_uint32_t)lo[k] >> 16);
+            peak[2 * k + 1] = max > -min ? max : -min;
+            energy[2 * k] = acc[2 * k];
+            energy[2 * k + 1] = acc[2 * k + 1];
+        }
+        return;
+    }
+#endif
+
+    /* portable path, simple enough for the compiler to vectorize */
+    for (c = 0; c < channels; c++)
+    {
+        peak[c] = 0;
+        energy[c] = 0;
+    }
+
+    for (n = 0; n < frames; n++)
+    {
+        for (c = 0; c < channels; c++)
+        {
+            s = in[c];
+            energy[c] += (rt_uint32_t)(s * s);
+            if (s < 0)
+                s = -s;
+            if (s > peak[c])
+                peak[c] = s;
+        }
+        in += channels;
+    }
+}
+
+void wavmeter_reset(struct wavmeter *meter, int channels)
+{
+    meter->sequence++;
+    METER_BARRIER();
+    rt_memset(&meter->level, 0, sizeof(meter->level));
+    meter->level.channels = channels > PKG_WP_METER_CHANNELS_MAX ? 0 : channels;
+    METER_BARRIER();
+    meter->sequence++;
+}
+
+void wavmeter_update(struct wavmeter *meter, const void *data, rt_size_t size)
+{
+    rt_int32_t peak[PKG_WP_METER_CHANNELS_MAX];
+    rt_uint64_t energy[PKG_WP_METER_CHANNELS_MAX];
+    int c, channels = meter->level.channels;
+    rt_size_t frames;
+
+    if (channels == 0)
+        return;
+
+    frames = size / (channels * sizeof(rt_int16_t));
+    if (frames == 0)
+        return;
+
+    /* reduce outside of the write window, readers only retry on the short copy */
+    meter_reduce((const rt_int16_t *)data, frames, channels, peak, energy);
+
+    meter->sequence++;
+    METER_BARRIER();
+    for (c = 0; c < channels; c++)
+    {
+        meter->level.peak[c] = peak[c] > 32767 ? 32767 : peak[c];
+        meter->level.rms[c] = meter_sqrt((rt_uint32_t)(energy[c] / frames));
+    }
+    meter->level.blocks++;
+    METER_BARRIER();
+    meter->sequence++;
+}
+
+void wavmeter_read(const struct wavmeter *meter, struct wavmeter_level *level)
+{
+    rt_uint32_t sequence;
+
+    while (1)
+    {
+        sequence = meter->sequence;
+        if (sequence & 1)
+        {
+            /* the writer may be preempted by this thread, let it finish */
+            rt_thread_delay(1);
+            continue;
+        }
+
+        METER_BARRIER();
+        rt_memcpy(level, (const void *)&meter->level, sizeof(struct wavmeter_level));
+        METER_BARRIER();
+
+        if (meter->sequence == sequence)
+            break;
+    }
+}
@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavsource.h>
+
+#include <math.h>
+
+#define DBG_TAG              "WAV_MIX"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+#ifndef PKG_WP_MIX_INPUTS_MAX
+#define PKG_WP_MIX_INPUTS_MAX (4)
+#endif
+#ifndef PKG_WP_DUCK_DEPTH
+#define PKG_WP_DUCK_DEPTH (-12)
+#endif
+#ifndef PKG_WP_DUCK_ATTACK
+#define PKG_WP_DUCK_ATTACK (50)
+#endif
+#ifndef PKG_WP_DUCK_RELEASE
+#define PKG_WP_DUCK_RELEASE (500)
+#endif
+
+#define MIX_UNITY            (0x10000)      /* gain 1.0 in Q16 */
+
+struct mix_input
+{
+    struct wavsource *source;
+    int priority;
+    rt_int32_t gain;                        /* current ducking gain, Q16 */
+    rt_bool_t ended;
+};
+
+/*
+ * Sums 16 bits inputs of the same format. The ducking gain of each input is
+ * ramped while it is accumulated, an input is ducked as long as an input of
+ * higher priority is playing.
+ */
+struct wavsource_mix
+{
+    struct wavsource parent;
+    char name[RT_NAME_MAX];
+    struct wavsource_format format;
+    rt_bool_t format_valid;
+    rt_mutex_t lock;
+
+    struct mix_input input[PKG_WP_MIX_INPUTS_MAX];
+    int count;
+
+    /* ducking */
+    rt_int32_t duck;                        /* gain of ducked inputs, Q16 */
+    rt_int32_t attack_step;                 /* gain change per frame */
+    rt_int32_t release_step;
+    rt_uint16_t attack;                     /* ms */
+    rt_uint16_t release;
+
+    rt_int32_t *acc;
+    rt_size_t acc_frames;
+};
+
+static rt_int32_t mix_step(struct wavsource_mix *mix, rt_uint16_t ms)
+{
+    rt_uint32_t frames = mix->format.samplerate * ms / 1000;
+    rt_int32_t step;
+
+    if (frames == 0)
+        return MIX_UNITY;
+
+    step = (MIX_UNITY - mix->duck) / (rt_int32_t)frames;
+
+    return step > 0 ? step : 1;
+}
+
+static void mix_duck_update(struct wavsource_mix *mix)
+{
+    mix->attack_step = mix_step(mix, mix->attack);
+    mix->release_step = mix_step(mix, mix->release);
+}
+
+/* add samples to the sum, moving the gain one step per frame until it reaches the target */
+static void mix_accumulate(rt_int32_t *acc, const rt_int16_t *in, rt_size_t frames, int channels,
+                           rt_int32_t *gain, rt_int32_t target, rt_int32_t attack, rt_int32_t release)
+{
+    rt_int32_t g = *gain;
+    rt_size_t i;
+    int c;
+
+    for (i = 0; i < frames && g != target; i++)
+    {
+        if (g > target)
+            g = g - attack > target ? g - attack : target;
+        else
+            g = g + release < target ? g + release : target;
+
+        for (c = 0; c < channels; c++)
+            *acc++ += (*in++ * g) >> 16;
+    }
+    *gain = g;
+
+    frames = (frames - i) * channels;
+    if (g == MIX_UNITY)
+    {
+        for (i = 0; i < frames; i++)
+            acc[i] += in[i];
+    }
+    else
+    {
+        for (i = 0; i < frames; i++)
+            acc[i] += (in[i] * g) >> 16;
+    }
+}
+
+static void mix_input_remove(struct wavsource_mix *mix, int index)
+{
+    struct wavsource *source = mix->input[index].source;
+
+    mix->count--;
+    mix->input[index] = mix->input[mix->count];
+
+    source->ops->close(source);
+    wavsource_delete(source);
+}
+
+static rt_err_t mix_open(struct wavsource *source, struct wavsource_format *format)
+{
+    struct wavsource_mix *mix = (struct wavsource_mix *)source;
+
+    if (!mix->format_valid)
+    {
+        LOG_E("mix has no input");
+        return -RT_ERROR;
+    }
+
+    *format = mix->format;
+
+    return RT_EOK;
+}
+
+static rt_ssize_t mix_read(struct wavsource *source, void *buffer, rt_size_t size, void **data)
+{
+    struct wavsource_mix *mix = (struct wavsource_mix *)source;
+    struct mix_input *input;
+    rt_size_t frame_bytes, frames, done, mixed = 0, i;
+    rt_int16_t *out = buffer;
+    rt_ssize_t length;
+    rt_int32_t target, sample;
+    int channels, top, k;
+    void *in;
+
+    channels = mix->format.channels;
+    frame_bytes = channels * sizeof(rt_int16_t);
+    frames = size / frame_bytes;
+    *data = buffer;
+
+    rt_mutex_take(mix->lock, RT_WAITING_FOREVER);
+
+    if (frames > mix->acc_frames)
+    {
+        if (mix->acc)
+            rt_free(mix->acc);
+        mix->acc = rt_malloc(frames * channels * sizeof(rt_int32_t));
+        mix->acc_frames = mix->acc ? frames : 0;
+        if (mix->acc == RT_NULL)
+        {
+            rt_mutex_release(mix->lock);
+            return -RT_ENOMEM;
+        }
+    }
+    rt_memset(mix->acc, 0, frames * channels * sizeof(rt_int32_t));
+
+    top = 0;
+    for (k = 0; k < mix->count; k++)
+    {
+        if (k == 0 || mix->input[k].priority > top)
+            top = mix->input[k].priority;
+    }
+
+    for (k = 0; k < mix->count; k++)
+    {
+        input = &mix->input[k];
+        target = input->priority < top ? mix->duck : MIX_UNITY;
+
+        /* the input fills the sum straight from the memory it hands out */
+        done = 0;
+        while (done < frames)
+        {
+            length = input->source->ops->read(input->source, out + done * channels,
+                                              (frames - done) * frame_bytes, &in);
+            if (length <= 0)
+            {
+                input->ended = RT_TRUE;
+                break;
+            }
+
+            length /= frame_bytes;
+            mix_accumulate(mix->acc + done * channels, in, length, channels, &input->gain,
+                           target, mix->attack_step, mix->release_step);
+            if (input->source->ops->release)
+                input->source->ops->release(input->source, in, length * frame_bytes);
+            done += length;
+        }
+
+        if (done > mixed)
+            mixed = done;
+    }
+
+    for (k = mix->count - 1; k >= 0; k--)
+    {
+        if (mix->input[k].ended)
+            mix_input_remove(mix, k);
+    }
+
+    rt_mutex_release(mix->lock);
+
+    /* saturate the sum, the stream ends when every input has ended */
+    for (i = 0; i < mixed * channels; i++)
+    {
+        sample = mix->acc[i];
+        out[i] = sample > 32767 ? 32767 : (sample < -32768 ? -32768 : sample);
+    }
+
+    return mixed * frame_bytes;
+}
+
+static void mix_close(struct wavsource *source)
+{
+    struct wavsource_mix *mix = (struct wavsource_mix *)source;
+
+    rt_mutex_take(mix->lock, RT_WAITING_FOREVER);
+    while (mix->count > 0)
+        mix_input_remove(mix, mix->count - 1);
+    rt_mutex_release(mix->lock);
+}
+
+static void mix_destroy(struct wavsource *source)
+{
+    struct wavsource_mix *mix = (struct wavsource_mix *)source;
+
+    mix_close(source);
+    if (mix->acc)
+        rt_free(mix->acc);
+    rt_mutex_delete(mix->lock);
+    rt_free(mix);
+}
+
+static const struct wavsource_ops mix_ops =
+{
+    mix_open,
+    mix_read,
+    RT_NULL,
+    RT_NULL,
+    mix_close,
+    mix_destroy,
+    RT_NULL,
+};
+
+struct wavsource *wavsource_mix_create(const struct wavsource_format *format)
+{
+    struct wavsource_mix *mix;
+
+    if (format && (format->samplebits != 16 || format->encoding != WAVSOURCE_ENCODING_PCM ||
+                   format->channels == 0 || format->samplerate == 0))
+    {
+        LOG_E("mix only supports 16 bits pcm");
+        return RT_NULL;
+    }
+
+    mix = rt_malloc(sizeof(struct wavsource_mix));
+    if (mix == RT_NULL)
+        return RT_NULL;
+    rt_memset(mix, 0, sizeof(struct wavsource_mix));
+
+    mix->lock = rt_mutex_create("wp_mix", RT_IPC_FLAG_PRIO);
+    if (mix->lock == RT_NULL)
+    {
+        rt_free(mix);
+        return RT_NULL;
+    }
+
+    if (format)
+    {
+        mix->format = *format;
+        mix->format_valid = RT_TRUE;
+    }
+    mix->duck = (rt_int32_t)(MIX_UNITY * powf(10.0f, PKG_WP_DUCK_DEPTH / 20.0f));
+    mix->attack = PKG_WP_DUCK_ATTACK;
+    mix->release = PKG_WP_DUCK_RELEASE;
+    mix_duck_update(mix);
+
+    mix->parent.ops = &mix_ops;
+    rt_strncpy(mix->name, "mix", sizeof(mix->name));
+    mix->parent.name = mix->name;
+
+    return &mix->parent;
+}
+
+rt_err_t wavsource_mix_add(struct wavsource *source, struct wavsource *input, int priority)
+{
+    struct wavsource_mix *mix = (struct wavsource_mix *)source;
+    struct wavsource_format format;
+    rt_err_t result;
+    int k;
+
+    if (source == RT_NULL || source->ops != &mix_ops || input == RT_NULL)
+        return -RT_EINVAL;
+
+    result = input->ops->open(input, &format);
+    if (result != RT_EOK)
+        goto __exit;
+
+    rt_mutex_take(mix->lock, RT_WAITING_FOREVER);
+
+    if (!mix->format_valid && format.samplebits == 16 && format.encoding == WAVSOURCE_ENCODING_PCM)
+    {
+        mix->format = format;
+        mix->format_valid = RT_TRUE;
+        mix_duck_update(mix);
+    }
+
+    if (format.samplerate != mix->format.samplerate || format.channels != mix->format.channels ||
+        format.samplebits != mix->format.samplebits || format.encoding != mix->format.encoding)
+    {
+        LOG_E("%s doesn't match the mix format", input->name);
+        result = -RT_EINVAL;
+    }
+    else if (mix->count == PKG_WP_MIX_INPUTS_MAX)
+    {
+        result = -RT_EFULL;
+    }
+    else
+    {
+        k = mix->count++;
+        mix->input[k].source = input;
+        mix->input[k].priority = priority;
+        mix->input[k].gain = MIX_UNITY;
+        mix->input[k].ended = RT_FALSE;
+    }
+
+    rt_mutex_release(mix->lock);
+
+    if (result != RT_EOK)
+        input->ops->close(input);
+
+__exit:
+    if (result != RT_EOK)
+        wavsource_delete(input);
+
+    return result;
+}
+
+rt_err_t wavsource_mix_remove(struct wavsource *source, struct wavsource *input)
+{
+    struct wavsource_mix *mix = (struct wavsource_mix *)source;
+    rt_err_t result = -RT_EEMPTY;
+    int k;
+
+    if (source == RT_NULL || source->ops != &mix_ops)
+        return -RT_EINVAL;
+
+    rt_mutex_take(mix->lock, RT_WAITING_FOREVER);
+    for (k = 0; k < mix->count; k++)
+    {
+        if (mix->input[k].source == input)
+        {
+            mix_input_remove(mix, k);
+            result = RT_EOK;
+            break;
+        }
+    }
+    rt_mutex_release(mix->lock);
+
+    return result;
+}
+
+rt_err_t wavsource_mix_duck_set(struct wavsource *source, float depth, rt_uint16_t attack, rt_uint16_t release)
+{
+    struct wavsource_mix *mix = (struct wavsource_mix *)source;
+
+    if (source == RT_NULL || source->ops != &mix_ops || depth > 0.0f)
+        return -RT_EINVAL;
+
+    rt_mutex_take(mix->lock, RT_WAITING_FOREVER);
+    mix->duck = (rt_int32_t)(MIX_UNITY * powf(10.0f, depth / 20.0f));
+    mix->attack = attack;
+    mix->release = release;
+    mix_duck_update(mix);
+    rt_mutex_release(mix->lock);
+
+    return RT_EOK;
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <wavpcm.h>
+
+/*
+ * Two frames are handled per iteration, so each output receives its two samples
+ * with one 32 bits store. The input block is walked once, all outputs are filled
+ * while its frames are in cache. Samples are little endian like the sound device.
+ */
+void wavpcm_deinterleave16(const rt_int16_t *in, void *const *out, const rt_uint8_t *map,
+                           int outputs, int channels, rt_size_t frames)
+{
+    rt_size_t n, pairs = frames / 2;
+    const rt_int16_t *next;
+    rt_uint32_t *dst;
+    int o, c;
+
+    for (n = 0; n < pairs; n++)
+    {
+        next = in + channels;
+        for (o = 0; o < outputs; o++)
+        {
+            c = map[o];
+            dst = (rt_uint32_t *)out[o] + n;
+            *dst = (rt_uint16_t)in[c] | ((rt_uint32_t)(rt_uint16_t)next[c] << 16);
+        }
+        in = next + channels;
+    }
+
+    /* odd frame at the tail */
+    if (frames & 1)
+    {
+        for (o = 0; o < outputs; o++)
+            ((rt_int16_t *)out[o])[frames - 1] = in[map[o]];
+    }
+}
+
+void wavpcm_deinterleave32(const rt_int32_t *in, void *const *out, const rt_uint8_t *map,
+                           int outputs, int channels, rt_size_t frames)
+{
+    rt_size_t n;
+    int o;
+
+    for (n = 0; n < frames; n++)
+    {
+        for (o = 0; o < outputs; o++)
+            ((rt_int32_t *)out[o])[n] = in[map[o]];
+        in += channels;
+    }
+}
+
+/*
+ * Four samples are packed into three 32 bits words, the output never overtakes
+ * the input so the conversion can run in place. Little endian like the sound device.
+ */
+void wavpcm_pack24(const rt_int32_t *in, rt_uint8_t *out, rt_size_t samples)
+{
+    const rt_uint32_t *src = (const rt_uint32_t *)in;
+    rt_uint32_t *dst = (rt_uint32_t *)out;
+    rt_uint32_t a, b, c, d;
+    rt_size_t n, quads = samples / 4;
+
+    for (n = 0; n < quads; n++)
+    {
+        a = src[0] >> 8;
+        b = src[1] >> 8;
+        c = src[2] >> 8;
+        d = src[3] >> 8;
+        dst[0] = a | (b << 24);
+        dst[1] = (b >> 8) | (c << 16);
+        dst[2] = (c >> 16) | (d << 8);
+        src += 4;
+        dst += 3;
+    }
+
+    out = (rt_uint8_t *)dst;
+    for (n = quads * 4; n < samples; n++)
+    {
+        a = *src++;
+        *out++ = a >> 8;
+        *out++ = a >> 16;
+        *out++ = a >> 24;
+    }
+}
+
+void wavpcm_float32(const rt_int32_t *in, float *out, rt_size_t samples)
+{
+    rt_size_t n;
+
+    for (n = 0; n < samples; n++)
+        out[n] = (float)in[n] * (1.0f / 2147483648.0f);
+}
+
+/* quantization error fed back by the noise shaper is bounded after clipping */
+#define DITHER_ERROR_MAX     (1L << 17)
+
+void wavpcm_dither_init(struct wavpcm_dither *dither, int mode)
+{
+    int c;
+
+    dither->mode = mode;
+    for (c = 0; c < PKG_WP_DITHER_CHANNELS_MAX; c++)
+    {
+        /* independent non zero generators keep the channels uncorrelated */
+        dither->seed[c] = 0x9E3779B9UL * (c + 1);
+        dither->error[c] = 0;
+    }
+}
+
+static rt_int32_t pcm_from_float(float value)
+{
+    if (value >= 1.0f)
+        return 0x7FFFFFFF;
+    if (value <= -1.0f)
+        return (rt_int32_t)0x80000000;
+    if (value != value)
+        return 0;
+
+    return (rt_int32_t)(value * 2147483648.0f);
+}
+
+/*
+ * One frame of 32 bits scale samples to 16 bits. The state of every channel is
+ * an array lane and the loop body only shifts, adds and selects, so the channel
+ * loop maps onto SIMD lanes where the compiler supports it.
+ *
+ *   v = x - e            noise shaping subtracts the last error
+ *   y = round(v + d)     d is TPDF, sum of two uniform 16 bits values
+ *   e = y - v            first order error feedback, noise is shaped by 1 - z^-1
+ */
+rt_inline void requantize_frame(struct wavpcm_dither *dither, const rt_int32_t *x, rt_int16_t *out,
+                                int channels, int mode)
+{
+    rt_bool_t shaped = mode == WAVPCM_DITHER_SHAPED;
+    rt_bool_t tpdf = mode != WAVPCM_DITHER_NONE;
+    rt_int64_t v, y, e;
+    rt_uint32_t r;
+    rt_int32_t d;
+    int c;
+
+    for (c = 0; c < channels; c++)
+    {
+        v = shaped ? (rt_int64_t)x[c] - dither->error[c] : x[c];
+
+        d = 0;
+        if (tpdf)
+        {
+            r = dither->seed[c];
+            r ^= r << 13;
+            r ^= r >> 17;
+            r ^= r << 5;
+            dither->seed[c] = r;
+            d = (rt_int32_t)(r & 0xFFFF) + (rt_int32_t)(r >> 16) - 0xFFFF;
+        }
+
+        y = (v + d + 0x8000) >> 16;
+        if (y > 32767)
+            y = 32767;
+        else if (y < -32768)
+            y = -32768;
+
+        if (shaped)
+        {
+            e = y * 65536 - v;
+            if (e > DITHER_ERROR_MAX)
+                e = DITHER_ERROR_MAX;
+            else if (e < -DITHER_ERROR_MAX)
+                e = -DITHER_ERROR_MAX;
+            dither->error[c] = (rt_int32_t)e;
+        }
+
+        out[c] = (rt_int16_t)y;
+    }
+}
+
+/* sample c of a frame of each source format, scaled to 32 bits */
+#define PCM_LOAD_S24(src, c) ((rt_int32_t)(((rt_uint32_t)(src)[3 * (c)] << 8) |          \
+                                           ((rt_uint32_t)(src)[3 * (c) + 1] << 16) |     \
+                                           ((rt_uint32_t)(src)[3 * (c) + 2] << 24)))
+#define PCM_LOAD_S32(src, c) (((const rt_int32_t *)(src))[c])
+#define PCM_LOAD_F32(src, c) pcm_from_float(((const float *)(src))[c])
+
+/*
+ * The source format is unpacked and requantized in the same pass. A frame is read
+ * before it is written and the output is never wider than the input, so the
+ * conversion can run in place. Kernels are expanded from one template, with the
+ * channels and the dither mode as constants the frame loop is unrolled and the
+ * mode branches are removed, the generic kernels take both from their arguments.
+ */
+#define PCM_REQUANTIZE_DEFINE(name, load, width, nch, nmode)                             \
+static void name(struct wavpcm_dither *dither, const void *in, rt_int16_t *out,          \
+                 int channels, rt_size_t frames)                                         \
+{                                                                                        \
+    const rt_uint8_t *src = (const rt_uint8_t *)in;                                      \
+    rt_int32_t x[PKG_WP_DITHER_CHANNELS_MAX];                                            \
+    rt_size_t n;                                                                         \
+    int c;                                                                               \
+                                                                                         \
+    (void)channels;                                                                      \
+    for (n = 0; n < frames; n++)                                                         \
+    {                                                                                    \
+        for (c = 0; c < (nch); c++)                                                      \
+            x[c] = load(src, c);                                                         \
+        src += (nch) * (width);                                                          \
+        requantize_frame(dither, x, out, (nch), (nmode));                                \
+        out += (nch);                                                                    \
+    }                                                                                    \
+}
+
+/* one kernel per dither mode of a format and channel count */
+#define PCM_REQUANTIZE_MODES(fmt, load, width, nch)                                      \
+    PCM_REQUANTIZE_DEFINE(requantize_##fmt##_##nch##_none, load, width, nch, WAVPCM_DITHER_NONE)     \
+    PCM_REQUANTIZE_DEFINE(requantize_##fmt##_##nch##_tpdf, load, width, nch, WAVPCM_DITHER_TPDF)     \
+    PCM_REQUANTIZE_DEFINE(requantize_##fmt##_##nch##_shaped, load, width, nch, WAVPCM_DITHER_SHAPED)
+
+#define PCM_REQUANTIZE_ENTRY(fmt, nch)                                                   \
+    { requantize_##fmt##_##nch##_none, requantize_##fmt##_##nch##_tpdf, requantize_##fmt##_##nch##_shaped }
+#define PCM_REQUANTIZE_NONE  { RT_NULL, RT_NULL, RT_NULL }
+
+PCM_REQUANTIZE_DEFINE(requantize_s24, PCM_LOAD_S24, 3, channels, dither->mode)
+PCM_REQUANTIZE_DEFINE(requantize_s32, PCM_LOAD_S32, 4, channels, dither->mode)
+PCM_REQUANTIZE_DEFINE(requantize_f32, PCM_LOAD_F32, 4, channels, dither->mode)
+
+#if (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_S24) && (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_MONO)
+PCM_REQUANTIZE_MODES(s24, PCM_LOAD_S24, 3, 1)
+#define PCM_S24_1 PCM_REQUANTIZE_ENTRY(s24, 1)
+#else
+#define PCM_S24_1 PCM_REQUANTIZE_NONE
+#endif
+#if (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_S24) && (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_STEREO)
+PCM_REQUANTIZE_MODES(s24, PCM_LOAD_S24, 3, 2)
+#define PCM_S24_2 PCM_REQUANTIZE_ENTRY(s24, 2)
+#else
+#define PCM_S24_2 PCM_REQUANTIZE_NONE
+#endif
+#if (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_S32) && (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_MONO)
+PCM_REQUANTIZE_MODES(s32, PCM_LOAD_S32, 4, 1)
+#define PCM_S32_1 PCM_REQUANTIZE_ENTRY(s32, 1)
+#else
+#define PCM_S32_1 PCM_REQUANTIZE_NONE
+#endif
+#if (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_S32) && (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_STEREO)
+PCM_REQUANTIZE_MODES(s32, PCM_LOAD_S32, 4, 2)
+#define PCM_S32_2 PCM_REQUANTIZE_ENTRY(s32, 2)
+#else
+#define PCM_S32_2 PCM_REQUANTIZE_NONE
+#endif
+#if (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_F32) && (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_MONO)
+PCM_REQUANTIZE_MODES(f32, PCM_LOAD_F32, 4, 1)
+#define PCM_F32_1 PCM_REQUANTIZE_ENTRY(f32, 1)
+#else
+#define PCM_F32_1 PCM_REQUANTIZE_NONE
+#endif
+#if (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_F32) && (PKG_WP_PCM_KERNELS & WAVPCM_KERNEL_STEREO)
+PCM_REQUANTIZE_MODES(f32, PCM_LOAD_F32, 4, 2)
+#define PCM_F32_2 PCM_REQUANTIZE_ENTRY(f32, 2)
+#else
+#define PCM_F32_2 PCM_REQUANTIZE_NONE
+#endif
+
+enum PCM_FORMAT
+{
+    PCM_FORMAT_S24 = 0,
+    PCM_FORMAT_S32 = 1,
+    PCM_FORMAT_F32 = 2,
+    PCM_FORMAT_MAX,
+};
+
+/* [format][channels - 1][dither mode], RT_NULL where the kernel isn't compiled in */
+static const wavpcm_requantize_t requantize_kernels[PCM_FORMAT_MAX][2][3] =
+{
+    { PCM_S24_1, PCM_S24_2 },
+    { PCM_S32_1, PCM_S32_2 },
+    { PCM_F32_1, PCM_F32_2 },
+};
+
+static const wavpcm_requantize_t requantize_generic[PCM_FORMAT_MAX] =
+{
+    requantize_s24,
+    requantize_s32,
+    requantize_f32,
+};
+
+wavpcm_requantize_t wavpcm_requantize_select(int samplebits, rt_bool_t is_float, int channels, int mode)
+{
+    wavpcm_requantize_t kernel = RT_NULL;
+    int format;
+
+    if (channels <= 0 || channels > PKG_WP_DITHER_CHANNELS_MAX)
+        return RT_NULL;
+
+    if (is_float && samplebits == 32)
+        format = PCM_FORMAT_F32;
+    else if (samplebits == 24)
+        format = PCM_FORMAT_S24;
+    else if (samplebits == 32)
+        format = PCM_FORMAT_S32;
+    else
+        return RT_NULL;
+
+    if (channels <= 2 && mode >= WAVPCM_DITHER_NONE && mode <= WAVPCM_DITHER_SHAPED)
+        kernel = requantize_kernels[format][channels - 1][mode];
+
+    return kernel ? kernel : requantize_generic[format];
+}
+
+void wavpcm_requantize16(struct wavpcm_dither *dither, const void *in, int samplebits, rt_bool_t is_float,
+                         rt_int16_t *out, int channels, rt_size_t frames)
+{
+    wavpcm_requantize_t kernel;
+
+    RT_ASSERT(channels <= PKG_WP_DITHER_CHANNELS_MAX);
+
+    kernel = wavpcm_requantize_select(samplebits, is_float, channels, dither->mode);
+    RT_ASSERT(kernel != RT_NULL);
+    kernel(dither, in, out, channels, frames);
+}
@@ -10,7 +10,15 @@
 #include <rtthread.h>
 #include <rtdevice.h>
 #include <wavhdr.h>
+#include <wavio.h>
+#include <wavsource.h>
+#include <wavpcm.h>
+#include <wavpool.h>
 #include <wavplayer.h>
+#include <wavtrace.h>
+#ifdef PKG_WP_USING_DSP
+#include <wavdsp.h>
+#endif
 
 #define DBG_TAG              "WAV_PLAYER"
 #define DBG_LVL              DBG_INFO
@@ -19,11 +27,91 @@
 #define VOLUME_MIN (0)
 #define VOLUME_MAX (99)
 
-#define WP_BUFFER_SIZE (2048)
+#ifndef PKG_WP_BUFFER_SIZE
+#define PKG_WP_BUFFER_SIZE (2048)
+#endif
+#ifndef PKG_WP_BUFFER_COUNT
+#define PKG_WP_BUFFER_COUNT (2)
+#endif
+#ifndef PKG_WP_BUFFER_COUNT_MAX
+#define PKG_WP_BUFFER_COUNT_MAX (8)
+#endif
+#ifndef PKG_WP_RAM_LIMIT
+#define PKG_WP_RAM_LIMIT (16 * 1024)
+#endif
+#if PKG_WP_RAM_LIMIT < PKG_WP_BUFFER_SIZE * PKG_WP_BUFFER_COUNT
+#error "PKG_WP_RAM_LIMIT must hold PKG_WP_BUFFER_COUNT blocks of PKG_WP_BUFFER_SIZE"
+#endif
+#ifndef PKG_WP_STABLE_TIME
+#define PKG_WP_STABLE_TIME (10000)
+#endif
+#ifndef PKG_WP_THREAD_STACK_SIZE
+#define PKG_WP_THREAD_STACK_SIZE (2048)
+#endif
+#ifndef PKG_WP_THREAD_PRIORITY
+#define PKG_WP_THREAD_PRIORITY (15)
+#endif
+#ifndef PKG_WP_IO_STACK_SIZE
+#define PKG_WP_IO_STACK_SIZE (1024)
+#endif
+#ifndef PKG_WP_IO_THREAD_PRIORITY
+#define PKG_WP_IO_THREAD_PRIORITY (14)
+#endif
+#ifndef PKG_WP_KEEPALIVE_TIME
+#define PKG_WP_KEEPALIVE_TIME (0)
+#endif
+#ifndef PKG_WP_PLAY_SAMPLEBITS
+#define PKG_WP_PLAY_SAMPLEBITS (0)
+#endif
+#ifndef PKG_WP_DITHER
+#define PKG_WP_DITHER (WAVPCM_DITHER_TPDF)
+#endif
+#ifndef PKG_WP_CROSSFADE_TIME
+#define PKG_WP_CROSSFADE_TIME (0)
+#endif
+#ifndef PKG_WP_DSP_STACK_SIZE
+#define PKG_WP_DSP_STACK_SIZE (2048)
+#endif
+#ifndef PKG_WP_IO_CPU
+#define PKG_WP_IO_CPU (0xFF)
+#endif
+#ifndef PKG_WP_DSP_CPU
+#define PKG_WP_DSP_CPU (0xFF)
+#endif
+#ifndef PKG_WP_SINK_CPU
+#define PKG_WP_SINK_CPU (0xFF)
+#endif
+#ifndef PKG_WP_BURST_SIZE
+#define PKG_WP_BURST_SIZE (0)
+#endif
+#ifndef PKG_WP_BURST_LOW
+#define PKG_WP_BURST_LOW (2)
+#endif
+#ifdef PKG_WP_USING_ADAPTIVE_BUFFER
+#define WP_ADAPTIVE_DEFAULT (1)
+#else
+#define WP_ADAPTIVE_DEFAULT (0)
+#endif
+#ifdef PKG_WP_USING_METER
+#define WP_METER_DEFAULT (1)
+#else
+#define WP_METER_DEFAULT (0)
+#endif
+#ifdef PKG_WP_USING_PIPELINE
+#define WP_PIPELINE_DEFAULT (1)
+#else
+#define WP_PIPELINE_DEFAULT (0)
+#endif
+
+/* orders the queue slots against the indexes on multi core targets */
+#if defined(RT_USING_SMP) && defined(__GNUC__)
+#define PLAY_BARRIER() __sync_synchronize()
+#else
+#define PLAY_BARRIER()
+#endif
+
 #define WP_VOLUME_DEFAULT (55)
 #define WP_MSG_SIZE (10)
-#define WP_THREAD_STATCK_SIZE (2048)
-#define WP_THREAD_PRIORITY (15)
 
 enum MSG_TYPE
 {
@@ -32,6 +120,8 @@ enum MSG_TYPE
     MSG_STOP   = 2,
     MSG_PAUSE  = 3,
     MSG_RESUME = 4,
+    MSG_CONFIG = 5,
+    MSG_EXIT   = 6,
 };
 
 enum PLAYER_EVENT
@@ -41,28 +131,159 @@ enum PLAYER_EVENT
     PLAYER_EVENT_STOP   = 2,
     PLAYER_EVENT_PAUSE  = 3,
     PLAYER_EVENT_RESUME = 4,
+    PLAYER_EVENT_EXIT   = 5,
 };
 
 struct play_msg
 {
     int type;
     void *data;
+    struct rt_completion *ack;              /* RT_NULL for asynchronous requests */
+    int *result;
+};
+
+enum PLAY_THREAD
+{
+    PLAY_THREAD_IO   = 0,
+    PLAY_THREAD_DSP  = 1,
+    PLAY_THREAD_SINK = 2,
+    PLAY_THREAD_MAX,
+};
+
+/* audio block passed between the stream reader and the player thread */
+struct play_block
+{
+    rt_uint8_t *buffer;                     /* storage of the block */
+    rt_uint8_t *data;                       /* data read, buffer or memory of the source */
+    rt_size_t length;
+    rt_uint8_t *out;                        /* processed data written to the device */
+    rt_size_t out_length;
+};
+
+/* single producer single consumer queue of blocks */
+struct play_queue
+{
+    struct play_block *slot[PKG_WP_BUFFER_COUNT_MAX + 1];
+    volatile rt_uint16_t head;
+    volatile rt_uint16_t tail;
 };
 
 struct wavplayer
 {
+    char device_name[RT_NAME_MAX];
     int state;
-    char *uri;
-    char *buffer;
+    struct wavsource *source;
+    char uri[PKG_WP_URI_MAX];               /* copy of the source name handed to callers */
     rt_device_t device;
     rt_mq_t mq;
     rt_mutex_t lock;
-    struct rt_completion ack;
-    FILE *fp;
     int volume;
+
+#ifdef PKG_WP_USING_CROSSFADE
+    /* crossfade wrapping the stream, guarded by xfade_lock while tracks are handed to it */
+    rt_mutex_t xfade_lock;
+    struct wavsource *xfade;
+#endif
+
+    struct wavplayer_config config;
+    rt_thread_t tid;
+
+    /* sound device kept open between streams */
+    rt_bool_t dev_opened;
+    rt_bool_t dev_warm;
+    rt_tick_t dev_warm_tick;
+    struct rt_audio_configure dev_config;
+    int dev_volume;
+
+    /* completion notification */
+    wavplayer_callback_t callback;
+    void *user_data;
+    rt_event_t notify;
+    struct play_msg start_msg;              /* MSG_START is acked once the stream is opened */
+    struct play_msg exit_msg;               /* MSG_EXIT is acked once the thread released everything */
+
+    /* file reader and block queues of the current stream */
+    rt_thread_t io_tid;
+    struct rt_completion io_exit;
+    volatile rt_bool_t io_quit;
+    rt_sem_t free_sem;
+    rt_sem_t fill_sem;
+    struct play_queue free_queue;
+    struct play_queue fill_queue;
+
+    /* processing thread between the reader and the player thread */
+    rt_bool_t pipeline;
+    rt_thread_t dsp_tid;
+    struct rt_completion dsp_exit;
+    rt_sem_t ready_sem;
+    struct play_queue ready_queue;
+    rt_uint64_t busy[PLAY_THREAD_MAX];      /* us each thread worked on the current stream */
+    rt_uint32_t block_size;
+    rt_uint16_t block_total;
+    rt_uint16_t block_target;
+    rt_bool_t primed;
+    rt_uint32_t underrun;
+    rt_tick_t adapt_tick;
+
+    /* burst mode, the blocks of a stream are slices of one buffer refilled at once */
+    rt_bool_t burst;
+    rt_uint8_t *burst_buffer;
+    struct play_block *burst_blocks;
+    rt_uint16_t burst_want;                 /* free blocks that start the next burst */
+    wavplayer_storage_hook_t storage_hook;
+    void *storage_data;
+
+    /* activity of the current or last stream */
+    rt_bool_t power_running;
+    rt_tick_t power_tick;
+    rt_tick_t power_end;
+    rt_tick_t storage_ticks;
+    rt_uint32_t io_wakeups;
+    rt_uint32_t write_wakeups;
+
+    /* levels of the played blocks, read without player.lock */
+    struct wavmeter meter;
+
+    /* format of the current stream and processing stages run before the sound device */
+    struct wavsource_format format;
+    rt_uint16_t samplebits;                 /* bits written to the sound device */
+    rt_bool_t requantize;                   /* wide or float stream played as 16 bits */
+    wavpcm_requantize_t requantize_fn;      /* kernel of the stream format, selected at open */
+    struct wavpcm_dither dither;
+#ifdef PKG_WP_USING_DSP
+    struct wavdsp_stage *stages;
+    rt_int32_t *dsp_work;                   /* 32 bits samples passed between the stages */
+    rt_size_t dsp_work_size;
+#endif
+};
+
+static const struct wavplayer_config config_default =
+{
+    .buffer_size        = PKG_WP_BUFFER_SIZE,
+    .buffer_count       = PKG_WP_BUFFER_COUNT,
+    .buffer_count_max   = PKG_WP_BUFFER_COUNT_MAX,
+    .ram_limit          = PKG_WP_RAM_LIMIT,
+    .stable_time        = PKG_WP_STABLE_TIME,
+    .io_stack_size      = PKG_WP_IO_STACK_SIZE,
+    .thread_priority    = PKG_WP_THREAD_PRIORITY,
+    .io_thread_priority = PKG_WP_IO_THREAD_PRIORITY,
+    .adaptive           = WP_ADAPTIVE_DEFAULT,
+    .keepalive_time     = PKG_WP_KEEPALIVE_TIME,
+    .meter              = WP_METER_DEFAULT,
+    .samplebits         = PKG_WP_PLAY_SAMPLEBITS,
+    .dither             = PKG_WP_DITHER,
+    .burst_size         = PKG_WP_BURST_SIZE,
+    .burst_low          = PKG_WP_BURST_LOW,
+    .io_backend         = PKG_WP_IO_BACKEND,
+    .pipeline           = WP_PIPELINE_DEFAULT,
+    .io_cpu             = PKG_WP_IO_CPU,
+    .dsp_cpu            = PKG_WP_DSP_CPU,
+    .sink_cpu           = PKG_WP_SINK_CPU,
+    .crossfade          = PKG_WP_CROSSFADE_TIME,
 };
 
-static struct wavplayer player;
+/* instance behind the original single player API */
+static wavplayer_t player_default;
 
 #if (DBG_LEVEL >= DBG_LOG)
 
@@ -76,213 +297,1314 @@ static const char *state_str[] =
 static const char *event_str[] =
 {
     "NONE",
-    "PLAY"
-    "STOP"
-    "PAUSE"
-    "RESUME"
+    "PLAY",
+    "STOP",
+    "PAUSE",
+    "RESUME",
+    "EXIT",
 };
 
 #endif
 
-static void play_lock(void)
+static void play_lock(struct wavplayer *player)
+{
+    rt_mutex_take(player->lock, RT_WAITING_FOREVER);
+}
+
+static void play_unlock(struct wavplayer *player)
+{
+    rt_mutex_release(player->lock);
+}
+
+/* bind a thread to a core, cores out of range leave it free */
+static void play_thread_bind(rt_thread_t tid, rt_uint8_t cpu)
 {
-    rt_mutex_take(player.lock, RT_WAITING_FOREVER);
+#ifdef RT_USING_SMP
+    rt_ubase_t bind = cpu < RT_CPUS_NR ? cpu : RT_CPUS_NR;
+
+    if (tid)
+        rt_thread_control(tid, RT_THREAD_CTRL_BIND_CPU, (void *)bind);
+#endif
 }
 
-static void play_unlock(void)
+static rt_uint64_t play_clock_us(void)
 {
-    rt_mutex_release(player.lock);
+#ifdef RT_USING_CPUTIME
+    return clock_cpu_microsecond(clock_cpu_gettime());
+#else
+    return (rt_uint64_t)rt_tick_get() * 1000000 / RT_TICK_PER_SECOND;
+#endif
 }
 
-static rt_err_t play_msg_send(struct wavplayer *player, int type, void *data)
+static rt_err_t play_msg_send(struct wavplayer *player, int type, void *data,
+                              struct rt_completion *ack, int *result)
 {
     struct play_msg msg;
 
     msg.type = type;
     msg.data = data;
+    msg.ack = ack;
+    msg.result = result;
 
     return rt_mq_send(player->mq, &msg, sizeof(struct play_msg));
 }
 
-int wavplayer_play(char *uri)
+static void play_msg_ack(struct play_msg *msg, int result)
 {
-    rt_err_t result = RT_EOK;
+    struct rt_completion *ack = msg->ack;
 
-    rt_completion_init(&player.ack);
+    if (ack == RT_NULL)
+        return;
 
-    play_lock();
-    if (player.state != PLAYER_STATE_STOPED)
+    /* the waiter may release msg as soon as it is completed */
+    msg->ack = RT_NULL;
+    *msg->result = result;
+    rt_completion_done(ack);
+}
+
+/* release the data of a request that is never going to be handled */
+static void play_msg_drop(int type, void *data)
+{
+    struct wavsource *source;
+
+    switch (type)
     {
-        wavplayer_stop();
+    case MSG_START:
+        source = (struct wavsource *)data;
+        if (source->autodelete)
+            wavsource_delete(source);
+        break;
+
+    case MSG_CONFIG:
+        rt_free(data);
+        break;
+
+    default:
+        break;
     }
-    if (player.uri)
+}
+
+/*
+ * post a request to the player thread, optionally wait until it is handled.
+ * data is owned by the player thread, it is released here if it can't be posted.
+ */
+static int play_request(struct wavplayer *player, int type, void *data, rt_bool_t wait)
+{
+    struct rt_completion ack;
+    int result = RT_EOK;
+    rt_err_t err = -RT_ERROR;
+
+    if (wait)
+        rt_completion_init(&ack);
+
+    if (player->mq)
+        err = play_msg_send(player, type, data, wait ? &ack : RT_NULL, &result);
+    if (err != RT_EOK)
     {
-        rt_free(player.uri);
+        play_msg_drop(type, data);
+        return err;
     }
-    player.uri = rt_strdup(uri);
-    result = play_msg_send(&player, MSG_START, RT_NULL);
-    rt_completion_wait(&player.ack, RT_WAITING_FOREVER);
-    play_unlock();
+
+    if (wait)
+        rt_completion_wait(&ack, RT_WAITING_FOREVER);
 
     return result;
 }
 
-int wavplayer_stop(void)
+/* requests left behind the exit are never handled, release them and wake their waiters */
+static void play_msg_flush(struct wavplayer *player)
 {
-    rt_err_t result = RT_EOK;
+    struct play_msg msg;
+    rt_ssize_t result;
+
+    if (player->start_msg.data)
+    {
+        play_msg_drop(MSG_START, player->start_msg.data);
+        player->start_msg.data = RT_NULL;
+        play_msg_ack(&player->start_msg, -RT_ERROR);
+    }
+
+    while (1)
+    {
+        result = rt_mq_recv(player->mq, &msg, sizeof(struct play_msg), RT_WAITING_NO);
+#if defined(RT_VERSION_CHECK) && (RTTHREAD_VERSION >= RT_VERSION_CHECK(5, 0, 1))
+        if (result <= 0)
+#else
+        if (RT_EOK != result)
+#endif
+            break;
+
+        play_msg_drop(msg.type, msg.data);
+        play_msg_ack(&msg, -RT_ERROR);
+    }
+}
+
+static void play_notify(struct wavplayer *player, int event, int result)
+{
+    wavplayer_callback_t callback;
+    void *user_data;
+    rt_event_t notify;
+
+    play_lock(player);
+    callback = player->callback;
+    user_data = player->user_data;
+    notify = player->notify;
+    play_unlock(player);
+
+    if (callback)
+        callback(event, result, user_data);
+
+    if (notify)
+        rt_event_send(notify, event);
+}
+
+#ifdef PKG_WP_USING_CROSSFADE
+/* hand a track to the crossfade of the stream playing, fails when there is none */
+static int play_crossfade(struct wavplayer *player, struct wavsource *source, rt_bool_t now)
+{
+    int result = -RT_ERROR;
+
+    rt_mutex_take(player->xfade_lock, RT_WAITING_FOREVER);
+    if (player->xfade && player->state != PLAYER_STATE_STOPED)
+        result = wavsource_xfade_next(player->xfade, source, now);
+    rt_mutex_release(player->xfade_lock);
+
+    return result;
+}
+
+/* every stream is played through a crossfade while it is enabled, tracks can then follow it */
+static void play_crossfade_wrap(struct wavplayer *player)
+{
+    struct wavsource *xfade = RT_NULL;
+
+    if (player->config.crossfade > 0)
+    {
+        xfade = wavsource_xfade_create(player->source, player->config.crossfade);
+        if (xfade)
+        {
+            xfade->autodelete = RT_TRUE;
+            play_lock(player);
+            player->source = xfade;
+            play_unlock(player);
+        }
+    }
+
+    rt_mutex_take(player->xfade_lock, RT_WAITING_FOREVER);
+    player->xfade = xfade;
+    rt_mutex_release(player->xfade_lock);
+}
+#endif
+
+/* now replaces the track playing, otherwise the track follows it when crossfading */
+static int play_start(struct wavplayer *player, char *uri, rt_bool_t wait, rt_bool_t now)
+{
+    struct wavsource *source;
+    int backend;
+
+    play_lock(player);
+    backend = player->config.io_backend;
+    play_unlock(player);
+
+    source = wavsource_file_create_io(uri, backend);
+    if (source == RT_NULL)
+        return -RT_ENOMEM;
+    source->autodelete = RT_TRUE;
+
+#ifdef PKG_WP_USING_CROSSFADE
+    if (play_crossfade(player, source, now) == RT_EOK)
+        return RT_EOK;
+#endif
 
-    rt_completion_init(&player.ack);
+    return play_request(player, MSG_START, source, wait);
+}
+
+int wavplayer_inst_play_source(wavplayer_t player, struct wavsource *source)
+{
+    RT_ASSERT(player != RT_NULL);
+    RT_ASSERT(source != RT_NULL);
+
+#ifdef PKG_WP_USING_CROSSFADE
+    if (play_crossfade(player, source, RT_TRUE) == RT_EOK)
+        return RT_EOK;
+#endif
+
+    return play_request(player, MSG_START, source, RT_TRUE);
+}
+
+int wavplayer_inst_play_next(wavplayer_t player, char *uri)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_start(player, uri, RT_TRUE, RT_FALSE);
+}
+
+int wavplayer_inst_play_source_async(wavplayer_t player, struct wavsource *source)
+{
+    RT_ASSERT(player != RT_NULL);
+    RT_ASSERT(source != RT_NULL);
+
+#ifdef PKG_WP_USING_CROSSFADE
+    if (play_crossfade(player, source, RT_TRUE) == RT_EOK)
+        return RT_EOK;
+#endif
+
+    return play_request(player, MSG_START, source, RT_FALSE);
+}
+
+int wavplayer_inst_play_async(wavplayer_t player, char *uri)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_start(player, uri, RT_FALSE, RT_TRUE);
+}
+
+int wavplayer_inst_stop_async(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_request(player, MSG_STOP, RT_NULL, RT_FALSE);
+}
+
+int wavplayer_inst_pause_async(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_request(player, MSG_PAUSE, RT_NULL, RT_FALSE);
+}
+
+int wavplayer_inst_resume_async(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_request(player, MSG_RESUME, RT_NULL, RT_FALSE);
+}
+
+int wavplayer_inst_play(wavplayer_t player, char *uri)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_start(player, uri, RT_TRUE, RT_TRUE);
+}
+
+int wavplayer_inst_stop(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_request(player, MSG_STOP, RT_NULL, RT_TRUE);
+}
+
+int wavplayer_inst_pause(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_request(player, MSG_PAUSE, RT_NULL, RT_TRUE);
+}
+
+int wavplayer_inst_resume(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return play_request(player, MSG_RESUME, RT_NULL, RT_TRUE);
+}
+
+int wavplayer_inst_callback_set(wavplayer_t player, wavplayer_callback_t callback, void *user_data)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    play_lock(player);
+    player->callback = callback;
+    player->user_data = user_data;
+    play_unlock(player);
+
+    return RT_EOK;
+}
+
+int wavplayer_inst_notify_set(wavplayer_t player, rt_event_t event)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    play_lock(player);
+    player->notify = event;
+    play_unlock(player);
+
+    return RT_EOK;
+}
+
+int wavplayer_inst_volume_set(wavplayer_t player, int volume)
+{
+    struct rt_audio_caps caps;
+
+    RT_ASSERT(player != RT_NULL);
+
+    if (volume < VOLUME_MIN)
+        volume = VOLUME_MIN;
+    else if (volume > VOLUME_MAX)
+        volume = VOLUME_MAX;
+
+    player->device = rt_device_find(player->device_name);
+    if (player->device == RT_NULL)
+        return -RT_ERROR;
+
+    player->volume = volume;
+    player->dev_volume = volume;
+    caps.main_type = AUDIO_TYPE_MIXER;
+    caps.sub_type  = AUDIO_MIXER_VOLUME;
+    caps.udata.value = volume;
+
+    LOG_D("set volume = %d", volume);
+    return rt_device_control(player->device, AUDIO_CTL_CONFIGURE, &caps);
+}
+
+int wavplayer_inst_volume_get(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return player->volume;
+}
+
+int wavplayer_inst_state_get(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return player->state;
+}
+
+char *wavplayer_inst_uri_get(wavplayer_t player)
+{
+    char *uri = RT_NULL;
+
+    RT_ASSERT(player != RT_NULL);
+
+    /* the player thread deletes a replaced source, its name is copied while it is held */
+    play_lock(player);
+    if (player->source)
+    {
+        rt_strncpy(player->uri, player->source->name, sizeof(player->uri) - 1);
+        uri = player->uri;
+    }
+    play_unlock(player);
+
+    return uri;
+}
+
+int wavplayer_inst_config_get(wavplayer_t player, struct wavplayer_config *config)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    if (config == RT_NULL)
+        return -RT_EINVAL;
+
+    play_lock(player);
+    *config = player->config;
+    play_unlock(player);
+
+    return RT_EOK;
+}
+
+/* the mmap backend is only there when it is built */
+static rt_bool_t play_backend_check(int backend)
+{
+#ifndef PKG_WP_USING_IO_MMAP
+    if (backend == WAVIO_BACKEND_MMAP)
+    {
+        LOG_E("io backend %s isn't supported", wavio_backend_name(backend));
+        return RT_FALSE;
+    }
+#endif
+
+    return backend < WAVIO_BACKEND_MAX;
+}
+
+static rt_bool_t play_config_check(const struct wavplayer_config *config)
+{
+    return config != RT_NULL && config->buffer_size != 0 && config->buffer_count != 0 &&
+           config->buffer_count <= config->buffer_count_max &&
+           config->ram_limit >= (rt_uint64_t)config->buffer_size * config->buffer_count &&
+           config->buffer_count_max <= PKG_WP_BUFFER_COUNT_MAX &&
+           config->thread_priority < RT_THREAD_PRIORITY_MAX &&
+           config->io_thread_priority < RT_THREAD_PRIORITY_MAX &&
+           play_backend_check(config->io_backend) &&
+           (config->burst_size == 0 ||
+            (config->burst_low < config->buffer_count_max && config->burst_size / config->buffer_count_max > 0));
+}
+
+int wavplayer_inst_config_set(wavplayer_t player, const struct wavplayer_config *config)
+{
+    struct wavplayer_config *data;
+
+    RT_ASSERT(player != RT_NULL);
+
+    if (!play_config_check(config))
+        return -RT_EINVAL;
+
+    /* the player thread owns the configuration, hand over a copy */
+    data = rt_malloc(sizeof(struct wavplayer_config));
+    if (data == RT_NULL)
+        return -RT_ENOMEM;
+    *data = *config;
+
+    return play_request(player, MSG_CONFIG, data, RT_TRUE);
+}
+
+int wavplayer_inst_underrun_get(wavplayer_t player)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    return player->underrun;
+}
+
+int wavplayer_inst_meter_get(wavplayer_t player, struct wavmeter_level *level)
+{
+    RT_ASSERT(player != RT_NULL);
+    RT_ASSERT(level != RT_NULL);
+
+    wavmeter_read(&player->meter, level);
+
+    return RT_EOK;
+}
+
+int wavplayer_inst_storage_hook_set(wavplayer_t player, wavplayer_storage_hook_t hook, void *user_data)
+{
+    RT_ASSERT(player != RT_NULL);
+
+    play_lock(player);
+    player->storage_hook = hook;
+    player->storage_data = user_data;
+    play_unlock(player);
+
+    return RT_EOK;
+}
+
+static rt_uint32_t play_tick_to_ms(rt_tick_t tick)
+{
+    return (rt_uint32_t)((rt_uint64_t)tick * 1000 / RT_TICK_PER_SECOND);
+}
+
+int wavplayer_inst_power_stat_get(wavplayer_t player, struct wavplayer_power_stat *stat)
+{
+    rt_tick_t elapsed;
+
+    RT_ASSERT(player != RT_NULL);
+
+    if (stat == RT_NULL)
+        return -RT_EINVAL;
+
+    rt_memset(stat, 0, sizeof(struct wavplayer_power_stat));
+    if (player->power_running == RT_FALSE && player->power_end == player->power_tick)
+        return RT_EOK;
+
+    elapsed = (player->power_running ? rt_tick_get() : player->power_end) - player->power_tick;
+    stat->elapsed = play_tick_to_ms(elapsed);
+    stat->io_wakeups = player->io_wakeups;
+    stat->write_wakeups = player->write_wakeups;
+    /* reading block by block never leaves the storage idle long enough to power it down */
+    stat->storage_active = play_tick_to_ms(player->burst ? player->storage_ticks : elapsed);
+
+    return RT_EOK;
+}
+
+int wavplayer_inst_cpu_stat_get(wavplayer_t player, struct wavplayer_cpu_stat *stat)
+{
+    rt_uint64_t elapsed;
+
+    RT_ASSERT(player != RT_NULL);
+
+    if (stat == RT_NULL)
+        return -RT_EINVAL;
+
+    rt_memset(stat, 0, sizeof(struct wavplayer_cpu_stat));
+    if (player->power_running == RT_FALSE && player->power_end == player->power_tick)
+        return RT_EOK;
+
+    stat->elapsed = play_tick_to_ms((player->power_running ? rt_tick_get() : player->power_end) - player->power_tick);
+    if (stat->elapsed == 0)
+        return RT_EOK;
+
+    /* per mille of one core */
+    elapsed = (rt_uint64_t)stat->elapsed * 1000;
+    stat->io = (rt_uint16_t)(player->busy[PLAY_THREAD_IO] * 1000 / elapsed);
+    stat->dsp = (rt_uint16_t)(player->busy[PLAY_THREAD_DSP] * 1000 / elapsed);
+    stat->sink = (rt_uint16_t)(player->busy[PLAY_THREAD_SINK] * 1000 / elapsed);
+
+    return RT_EOK;
+}
+
+#ifdef PKG_WP_USING_DSP
+int wavplayer_inst_stage_add(wavplayer_t player, struct wavdsp_stage *stage)
+{
+    struct wavdsp_stage **node;
+
+    RT_ASSERT(player != RT_NULL);
+    RT_ASSERT(stage != RT_NULL);
+
+    rt_mutex_take(player->lock, RT_WAITING_FOREVER);
+    stage->next = RT_NULL;
+    stage->samplerate = 0;
+    stage->channels = 0;
+    for (node = &player->stages; *node != RT_NULL; node = &(*node)->next);
+    *node = stage;
+    rt_mutex_release(player->lock);
+
+    return RT_EOK;
+}
+
+int wavplayer_inst_stage_remove(wavplayer_t player, struct wavdsp_stage *stage)
+{
+    struct wavdsp_stage **node;
+    int result = -RT_ERROR;
+
+    RT_ASSERT(player != RT_NULL);
+    RT_ASSERT(stage != RT_NULL);
+
+    rt_mutex_take(player->lock, RT_WAITING_FOREVER);
+    for (node = &player->stages; *node != RT_NULL; node = &(*node)->next)
+    {
+        if (*node == stage)
+        {
+            *node = stage->next;
+            stage->next = RT_NULL;
+            result = RT_EOK;
+            break;
+        }
+    }
+    rt_mutex_release(player->lock);
+
+    return result;
+}
+
+/* run the stages on a block, memory handed out by zero copy sources is left untouched */
+static rt_uint8_t *wavplayer_process(struct wavplayer *player, struct play_block *block,
+                                     rt_uint8_t *data, rt_size_t length)
+{
+    int channels = player->format.channels;
+    rt_size_t size = length * 2;
+
+    if (player->samplebits != 16)
+        return data;
+
+    rt_mutex_take(player->lock, RT_WAITING_FOREVER);
+    if (player->stages && player->dsp_work_size < size)
+    {
+        wavpool_free(player->dsp_work);
+        player->dsp_work = wavpool_malloc(size);
+        player->dsp_work_size = player->dsp_work ? size : 0;
+    }
+    if (player->stages && player->dsp_work)
+    {
+        if (data != block->buffer)
+        {
+            rt_memcpy(block->buffer, data, length);
+            data = block->buffer;
+        }
+        wavdsp_chain_process(player->stages, (rt_int16_t *)data, player->dsp_work,
+                             length / (channels * sizeof(rt_int16_t)),
+                             player->format.samplerate, channels);
+    }
+    rt_mutex_release(player->lock);
+
+    return data;
+}
+#endif
+
+/* convert a wide block to 16 bits in the block buffer, returns the converted bytes */
+static rt_size_t wavplayer_requantize(struct wavplayer *player, struct play_block *block)
+{
+    int channels = player->format.channels;
+    rt_size_t frames = block->length / (channels * player->format.samplebits / 8);
+
+    player->requantize_fn(&player->dither, block->data, (rt_int16_t *)block->buffer, channels, frames);
+
+    return frames * channels * sizeof(rt_int16_t);
+}
+
+/* turn a block read from the source into the data written to the device */
+static void wavplayer_block_process(struct wavplayer *player, struct play_block *block)
+{
+    rt_uint8_t *data = block->data;
+    rt_size_t length = block->length;
+
+    if (length > 0)
+    {
+        WAVTRACE_BEGIN(WAVTRACE_EVENT_PROCESS, 0);
+        if (player->requantize)
+        {
+            length = wavplayer_requantize(player, block);
+            data = block->buffer;
+        }
+#ifdef PKG_WP_USING_DSP
+        data = wavplayer_process(player, block, data, length);
+#endif
+        if (player->config.meter)
+            wavmeter_update(&player->meter, data, length);
+        WAVTRACE_END(WAVTRACE_EVENT_PROCESS, length);
+    }
+
+    block->out = data;
+    block->out_length = length;
+}
+
+void wavplayer_config_default(struct wavplayer_config *config)
+{
+    *config = config_default;
+}
+
+static void play_queue_push(struct play_queue *queue, struct play_block *block)
+{
+    rt_uint16_t next = (queue->head + 1) % (PKG_WP_BUFFER_COUNT_MAX + 1);
+
+    RT_ASSERT(next != queue->tail);
+    queue->slot[queue->head] = block;
+    PLAY_BARRIER();
+    queue->head = next;
+}
+
+static struct play_block *play_queue_pop(struct play_queue *queue)
+{
+    struct play_block *block;
+
+    if (queue->tail == queue->head)
+        return RT_NULL;
+
+    PLAY_BARRIER();
+    block = queue->slot[queue->tail];
+    queue->tail = (queue->tail + 1) % (PKG_WP_BUFFER_COUNT_MAX + 1);
+
+    return block;
+}
+
+static struct play_block *play_block_alloc(rt_uint32_t size)
+{
+    struct play_block *block;
+
+    /* the samples start aligned for the DMA of the sound device */
+    block = wavpool_malloc(RT_ALIGN(sizeof(struct play_block), WAVPOOL_ALIGN) + size);
+    if (block == RT_NULL)
+        return RT_NULL;
+
+    block->buffer = (rt_uint8_t *)block + RT_ALIGN(sizeof(struct play_block), WAVPOOL_ALIGN);
+    block->data = block->buffer;
+    block->length = 0;
+
+    return block;
+}
+
+static rt_uint16_t play_queue_count(struct play_queue *queue)
+{
+    return (queue->head + PKG_WP_BUFFER_COUNT_MAX + 1 - queue->tail) % (PKG_WP_BUFFER_COUNT_MAX + 1);
+}
+
+/* add one block to the free queue, the file reader picks it up */
+static rt_err_t play_block_add(struct wavplayer *player)
+{
+    struct play_block *block;
+
+    if (player->block_total >= player->config.buffer_count_max ||
+        (player->block_total + 1) * player->block_size > player->config.ram_limit)
+        return -RT_EFULL;
+
+    block = play_block_alloc(player->block_size);
+    if (block == RT_NULL)
+        return -RT_ENOMEM;
+
+    player->block_total++;
+    play_queue_push(&player->free_queue, block);
+    rt_sem_release(player->free_sem);
+
+    return RT_EOK;
+}
+
+static void play_adapt_grow(struct wavplayer *player)
+{
+    player->underrun++;
+    player->adapt_tick = rt_tick_get();
+
+    if (!player->config.adaptive || player->burst)
+        return;
+
+    if (play_block_add(player) == RT_EOK)
+    {
+        player->block_target = player->block_total;
+        LOG_D("underrun, grow to %d blocks", player->block_total);
+    }
+}
+
+static void play_adapt_shrink(struct wavplayer *player)
+{
+    rt_tick_t stable = rt_tick_from_millisecond(player->config.stable_time);
+
+    if (!player->config.adaptive || player->burst || player->block_target <= player->config.buffer_count)
+        return;
+
+    if (rt_tick_get() - player->adapt_tick >= stable)
+    {
+        player->block_target--;
+        player->adapt_tick = rt_tick_get();
+        LOG_D("stable, shrink to %d blocks", player->block_target);
+    }
+}
+
+/* take a filled block, an empty queue after the first block is an underrun */
+static struct play_block *play_block_get(struct wavplayer *player)
+{
+    struct play_block *block;
+    rt_sem_t sem = player->pipeline ? player->ready_sem : player->fill_sem;
+
+    if (rt_sem_trytake(sem) != RT_EOK)
+    {
+        if (player->primed)
+            play_adapt_grow(player);
+        rt_sem_take(sem, RT_WAITING_FOREVER);
+    }
+    player->primed = RT_TRUE;
+
+    block = play_queue_pop(player->pipeline ? &player->ready_queue : &player->fill_queue);
+    RT_ASSERT(block != RT_NULL);
+
+    return block;
+}
+
+/* give a block back to the file reader, or release it when adaptive mode shrinks */
+static void play_block_put(struct wavplayer *player, struct play_block *block)
+{
+    /* the source may reuse memory it handed out for this block, bursts copied it already */
+    if (!player->burst && player->source->ops->release && block->length > 0)
+        player->source->ops->release(player->source, block->data, block->length);
+    block->data = block->buffer;
+
+    play_adapt_shrink(player);
+
+    if (player->block_total > player->block_target)
+    {
+        player->block_total--;
+        wavpool_free(block);
+        return;
+    }
+
+    play_queue_push(&player->free_queue, block);
+
+    /* the reader of burst mode sleeps until enough blocks came back for one burst */
+    if (!player->burst || play_queue_count(&player->free_queue) == player->burst_want)
+        rt_sem_release(player->free_sem);
+}
+
+static void wavplayer_io_entry(void *parameter)
+{
+    struct wavplayer *player = (struct wavplayer *)parameter;
+    struct play_block *block;
+    rt_uint64_t start;
+    rt_ssize_t length;
+    void *data;
+
+    while (1)
+    {
+        rt_sem_take(player->free_sem, RT_WAITING_FOREVER);
+        if (player->io_quit)
+            break;
+
+        block = play_queue_pop(&player->free_queue);
+        if (block == RT_NULL)
+            continue;
+        player->io_wakeups++;
+
+        /* read raw data from stream source, an empty block marks the end of stream */
+        start = play_clock_us();
+        WAVTRACE_BEGIN(WAVTRACE_EVENT_READ, 0);
+        length = player->source->ops->read(player->source, block->buffer, player->block_size, &data);
+        WAVTRACE_END(WAVTRACE_EVENT_READ, length > 0 ? length : 0);
+        player->busy[PLAY_THREAD_IO] += play_clock_us() - start;
+        if (length > 0)
+        {
+            block->data = data;
+            block->length = length;
+        }
+        else
+        {
+            block->data = block->buffer;
+            block->length = 0;
+        }
+        play_queue_push(&player->fill_queue, block);
+        rt_sem_release(player->fill_sem);
+
+        if (block->length == 0)
+            break;
+    }
+
+    rt_completion_done(&player->io_exit);
+}
+
+/* read until the buffer is full or the stream ends, returns the bytes read */
+static rt_size_t play_burst_read(struct wavplayer *player, rt_uint8_t *buffer, rt_size_t size)
+{
+    struct wavsource *source = player->source;
+    rt_size_t filled = 0;
+    rt_ssize_t length;
+    void *data;
+
+    while (filled < size)
+    {
+        length = source->ops->read(source, buffer + filled, size - filled, &data);
+        if (length <= 0)
+            break;
+
+        if (data != buffer + filled)
+            rt_memcpy(buffer + filled, data, length);
+        if (source->ops->release)
+            source->ops->release(source, data, length);
+        filled += length;
+    }
+
+    return filled;
+}
+
+static void wavplayer_burst_entry(void *parameter)
+{
+    struct wavplayer *player = (struct wavplayer *)parameter;
+    struct play_block *blocks[PKG_WP_BUFFER_COUNT_MAX];
+    rt_size_t filled, offset, run, count, i, k;
+    rt_bool_t eos = RT_FALSE;
+    rt_uint64_t start;
+    rt_tick_t tick;
+
+    while (!eos)
+    {
+        rt_sem_take(player->free_sem, RT_WAITING_FOREVER);
+        if (player->io_quit)
+            break;
+
+        /* take every block that came back, the player signals once they are enough for a burst */
+        count = 0;
+        while (count < PKG_WP_BUFFER_COUNT_MAX &&
+               (blocks[count] = play_queue_pop(&player->free_queue)) != RT_NULL)
+            count++;
+        if (count == 0)
+            continue;
+
+        player->io_wakeups++;
+        tick = rt_tick_get();
+        if (player->storage_hook)
+            player->storage_hook(RT_TRUE, player->storage_data);
+
+        /* blocks come back in order, so they are contiguous up to the end of the buffer */
+        for (i = 0; i < count && !eos; i += run)
+        {
+            for (run = 1; i + run < count; run++)
+            {
+                if (blocks[i + run]->buffer != blocks[i + run - 1]->buffer + player->block_size)
+                    break;
+            }
+
+            start = play_clock_us();
+            WAVTRACE_BEGIN(WAVTRACE_EVENT_READ, 0);
+            filled = play_burst_read(player, blocks[i]->buffer, run * player->block_size);
+            WAVTRACE_END(WAVTRACE_EVENT_READ, filled);
+            player->busy[PLAY_THREAD_IO] += play_clock_us() - start;
+
+            /* a short read is the end of stream, an empty block marks it */
+            for (k = 0; k < run && !eos; k++)
+            {
+                offset = k * player->block_size;
+                blocks[i + k]->data = blocks[i + k]->buffer;
+                blocks[i + k]->length = filled > offset ? filled - offset : 0;
+                if (blocks[i + k]->length > player->block_size)
+                    blocks[i + k]->length = player->block_size;
+                eos = blocks[i + k]->length == 0;
+
+                play_queue_push(&player->fill_queue, blocks[i + k]);
+                rt_sem_release(player->fill_sem);
+            }
+        }
+
+        if (player->storage_hook)
+            player->storage_hook(RT_FALSE, player->storage_data);
+        player->storage_ticks += rt_tick_get() - tick;
+    }
+
+    rt_completion_done(&player->io_exit);
+}
+
+/* pipeline, processes the blocks between the reader and the player thread */
+static void wavplayer_dsp_entry(void *parameter)
+{
+    struct wavplayer *player = (struct wavplayer *)parameter;
+    struct play_block *block;
+    rt_uint64_t start;
+
+    while (1)
+    {
+        rt_sem_take(player->fill_sem, RT_WAITING_FOREVER);
+        if (player->io_quit)
+            break;
+
+        block = play_queue_pop(&player->fill_queue);
+        if (block == RT_NULL)
+            continue;
+
+        start = play_clock_us();
+        wavplayer_block_process(player, block);
+        player->busy[PLAY_THREAD_DSP] += play_clock_us() - start;
+
+        play_queue_push(&player->ready_queue, block);
+        rt_sem_release(player->ready_sem);
+
+        if (block->length == 0)
+            break;
+    }
+
+    rt_completion_done(&player->dsp_exit);
+}
+
+/*
+ * slice one buffer of burst_size into the blocks, all of them are free for the first burst.
+ * It comes from the heap, not the pool, since it is larger than a pool block and is read into
+ * in one go, which needs the whole buffer aligned.
+ */
+static rt_err_t play_burst_alloc(struct wavplayer *player)
+{
+    rt_uint16_t count = player->config.buffer_count_max;
+    int i;
+
+    player->burst_buffer = rt_malloc_align(count * player->block_size, WAVPOOL_ALIGN);
+    player->burst_blocks = rt_malloc(count * sizeof(struct play_block));
+    if (player->burst_buffer == RT_NULL || player->burst_blocks == RT_NULL)
+        return -RT_ENOMEM;
+
+    for (i = 0; i < count; i++)
+    {
+        player->burst_blocks[i].buffer = player->burst_buffer + i * player->block_size;
+        player->burst_blocks[i].data = player->burst_blocks[i].buffer;
+        player->burst_blocks[i].length = 0;
+        play_queue_push(&player->free_queue, &player->burst_blocks[i]);
+    }
+    player->block_total = player->block_target = count;
+    player->burst_want = count - player->config.burst_low;
+    rt_sem_release(player->free_sem);
+
+    return RT_EOK;
+}
+
+static rt_err_t wavplayer_io_start(struct wavplayer *player)
+{
+    rt_uint32_t frame;
+    int i;
+
+    /* whole frames only, blocks are converted frame by frame */
+    player->burst = player->config.burst_size > 0;
+    if (player->burst)
+        player->block_size = player->config.burst_size / player->config.buffer_count_max;
+    else
+        player->block_size = player->config.buffer_size;
+    frame = player->format.channels * player->format.samplebits / 8;
+    if (frame == 0 || player->block_size < frame)
+    {
+        LOG_E("block of %d bytes can't hold a frame of %d bytes", player->block_size, frame);
+        return -RT_EINVAL;
+    }
+    player->block_size -= player->block_size % frame;
+    player->block_total = 0;
+    player->block_target = player->config.buffer_count;
+    player->primed = RT_FALSE;
+    player->underrun = 0;
+    player->adapt_tick = rt_tick_get();
+    player->io_quit = RT_FALSE;
+    player->io_wakeups = 0;
+    player->write_wakeups = 0;
+    player->storage_ticks = 0;
+    player->power_tick = rt_tick_get();
+    player->power_running = RT_TRUE;
+    player->free_queue.head = player->free_queue.tail = 0;
+    player->fill_queue.head = player->fill_queue.tail = 0;
+    player->ready_queue.head = player->ready_queue.tail = 0;
+    player->pipeline = player->config.pipeline;
+    rt_memset(player->busy, 0, sizeof(player->busy));
+    rt_completion_init(&player->io_exit);
+    rt_completion_init(&player->dsp_exit);
+
+    player->free_sem = rt_sem_create("wp_free", 0, RT_IPC_FLAG_FIFO);
+    player->fill_sem = rt_sem_create("wp_fill", 0, RT_IPC_FLAG_FIFO);
+    if (player->free_sem == RT_NULL || player->fill_sem == RT_NULL)
+        return -RT_ENOMEM;
+
+    if (player->burst)
+    {
+        if (play_burst_alloc(player) != RT_EOK)
+        {
+            LOG_E("malloc burst buffer for player failed");
+            return -RT_ENOMEM;
+        }
+    }
+    else
+    {
+        for (i = 0; i < player->block_target; i++)
+        {
+            if (play_block_add(player) != RT_EOK)
+                break;
+        }
+        if (player->block_total == 0)
+        {
+            LOG_E("malloc audio blocks for player failed");
+            return -RT_ENOMEM;
+        }
+    }
+
+    if (player->pipeline)
+    {
+        player->ready_sem = rt_sem_create("wp_ready", 0, RT_IPC_FLAG_FIFO);
+        if (player->ready_sem == RT_NULL)
+            return -RT_ENOMEM;
+
+        player->dsp_tid = rt_thread_create("wp_dsp",
+                                           wavplayer_dsp_entry,
+                                           player,
+                                           PKG_WP_DSP_STACK_SIZE,
+                                           player->config.thread_priority, 10);
+        if (player->dsp_tid == RT_NULL)
+            return -RT_ENOMEM;
+
+        play_thread_bind(player->dsp_tid, player->config.dsp_cpu);
+        rt_thread_startup(player->dsp_tid);
+    }
+
+    player->io_tid = rt_thread_create("wp_io",
+                                      player->burst ? wavplayer_burst_entry : wavplayer_io_entry,
+                                      player,
+                                      player->config.io_stack_size,
+                                      player->config.io_thread_priority, 10);
+    if (player->io_tid == RT_NULL)
+        return -RT_ENOMEM;
+
+    play_thread_bind(player->io_tid, player->config.io_cpu);
+    rt_thread_startup(player->io_tid);
+
+    return RT_EOK;
+}
+
+static void wavplayer_io_stop(struct wavplayer *player)
+{
+    struct play_block *block;
+
+    if (player->io_tid)
+    {
+        player->io_quit = RT_TRUE;
+        rt_sem_release(player->free_sem);
+        rt_completion_wait(&player->io_exit, RT_WAITING_FOREVER);
+        player->io_tid = RT_NULL;
+    }
+
+    if (player->dsp_tid)
+    {
+        player->io_quit = RT_TRUE;
+        rt_sem_release(player->fill_sem);
+        rt_completion_wait(&player->dsp_exit, RT_WAITING_FOREVER);
+        player->dsp_tid = RT_NULL;
+    }
+
+    if (player->power_running)
+    {
+        player->power_end = rt_tick_get();
+        player->power_running = RT_FALSE;
+    }
+
+    /* blocks still queued are dropped, the source is closed right after */
+    while ((block = play_queue_pop(&player->free_queue)) != RT_NULL)
+    {
+        if (!player->burst)
+            wavpool_free(block);
+    }
+    while ((block = play_queue_pop(&player->fill_queue)) != RT_NULL)
+    {
+        if (!player->burst)
+            wavpool_free(block);
+    }
+    while ((block = play_queue_pop(&player->ready_queue)) != RT_NULL)
+    {
+        if (!player->burst)
+            wavpool_free(block);
+    }
+    player->block_total = 0;
+
+    if (player->burst)
+    {
+        if (player->burst_buffer)
+            rt_free_align(player->burst_buffer);
+        if (player->burst_blocks)
+            rt_free(player->burst_blocks);
+        player->burst_buffer = RT_NULL;
+        player->burst_blocks = RT_NULL;
+
+        /* the storage is handed back powered, the source is closed and the next one opened */
+        if (player->storage_hook)
+            player->storage_hook(RT_TRUE, player->storage_data);
+    }
 
-    play_lock();
-    if (player.state != PLAYER_STATE_STOPED)
+    if (player->free_sem)
     {
-        result = play_msg_send(&player, MSG_STOP, RT_NULL);
-        rt_completion_wait(&player.ack, RT_WAITING_FOREVER);
+        rt_sem_delete(player->free_sem);
+        player->free_sem = RT_NULL;
     }
-    play_unlock();
 
-    return result;
-}
-
-int wavplayer_pause(void)
-{
-    rt_err_t result = RT_EOK;
-
-    rt_completion_init(&player.ack);
-
-    play_lock();
-    if (player.state == PLAYER_STATE_PLAYING)
+    if (player->fill_sem)
     {
-        result = play_msg_send(&player, MSG_PAUSE, RT_NULL);
-        rt_completion_wait(&player.ack, RT_WAITING_FOREVER);
+        rt_sem_delete(player->fill_sem);
+        player->fill_sem = RT_NULL;
     }
-    play_unlock();
 
-    return result;
+    if (player->ready_sem)
+    {
+        rt_sem_delete(player->ready_sem);
+        player->ready_sem = RT_NULL;
+    }
 }
 
-int wavplayer_resume(void)
+static void wavplayer_device_close(struct wavplayer *player)
 {
-    rt_err_t result = RT_EOK;
-
-    rt_completion_init(&player.ack);
-
-    play_lock();
-    if (player.state == PLAYER_STATE_PAUSED)
+    if (player->dev_opened)
     {
-        result = play_msg_send(&player, MSG_RESUME, RT_NULL);
-        rt_completion_wait(&player.ack, RT_WAITING_FOREVER);
+        rt_device_close(player->device);
+        player->dev_opened = RT_FALSE;
+        LOG_D("close device %s", player->device_name);
     }
-    play_unlock();
 
-    return result;
+    player->dev_warm = RT_FALSE;
+    player->device = RT_NULL;
 }
 
-int wavplayer_volume_set(int volume)
+/* open the sound device, or reuse the warm one and only reconfigure what changed */
+static rt_err_t wavplayer_device_open(struct wavplayer *player, struct rt_audio_configure *config)
 {
+    rt_err_t result;
     struct rt_audio_caps caps;
 
-    if (volume < VOLUME_MIN)
-        volume = VOLUME_MIN;
-    else if (volume > VOLUME_MAX)
-        volume = VOLUME_MAX;
-
-    player.device = rt_device_find(PKG_WP_PLAY_DEVICE);
-    if (player.device == RT_NULL)
-        return -RT_ERROR;
+    if (player->dev_opened == RT_FALSE)
+    {
+        /* find device */
+        player->device = rt_device_find(player->device_name);
+        if (player->device == RT_NULL)
+        {
+            LOG_E("device %s not find", player->device_name);
+            return -RT_ERROR;
+        }
 
-    player.volume = volume;
-    caps.main_type = AUDIO_TYPE_MIXER;
-    caps.sub_type  = AUDIO_MIXER_VOLUME;
-    caps.udata.value = volume;
+        /* open sound device */
+        result = rt_device_open(player->device, RT_DEVICE_OFLAG_WRONLY);
+        if (result != RT_EOK)
+        {
+            LOG_E("open %s device faield", player->device_name);
+            player->device = RT_NULL;
+            return result;
+        }
 
-    LOG_D("set volume = %d", volume);
-    return rt_device_control(player.device, AUDIO_CTL_CONFIGURE, &caps);
-}
+        player->dev_opened = RT_TRUE;
+        rt_memset(&player->dev_config, 0, sizeof(player->dev_config));
+        player->dev_volume = -1;
+    }
+    else
+    {
+        LOG_D("reuse warm device %s", player->device_name);
+    }
+    player->dev_warm = RT_FALSE;
 
-int wavplayer_volume_get(void)
-{
-    return player.volume;
-}
+    /* set sampletate,channels, samplebits */
+    if (rt_memcmp(&player->dev_config, config, sizeof(struct rt_audio_configure)) != 0)
+    {
+        caps.main_type = AUDIO_TYPE_OUTPUT;
+        caps.sub_type  = AUDIO_DSP_PARAM;
+        caps.udata.config = *config;
+        rt_device_control(player->device, AUDIO_CTL_CONFIGURE, &caps);
+        player->dev_config = *config;
+    }
 
-int wavplayer_state_get(void)
-{
-    return player.state;
-}
+    /* set volume according to configuration */
+    if (player->dev_volume != player->volume)
+    {
+        caps.main_type = AUDIO_TYPE_MIXER;
+        caps.sub_type  = AUDIO_MIXER_VOLUME;
+        caps.udata.value = player->volume;
+        rt_device_control(player->device, AUDIO_CTL_CONFIGURE, &caps);
+        player->dev_volume = player->volume;
+    }
 
-char *wavplayer_uri_get(void)
-{
-    return player.uri;
+    return RT_EOK;
 }
 
 static rt_err_t wavplayer_open(struct wavplayer *player)
 {
     rt_err_t result = RT_EOK;
-    struct rt_audio_caps caps;
-    struct wav_header wav;
+    struct rt_audio_configure config;
+    struct wavsource_format format;
 
-    /* find device */
-    player->device = rt_device_find(PKG_WP_PLAY_DEVICE);
-    if (player->device == RT_NULL)
+    /* open stream source */
+    result = player->source->ops->open(player->source, &format);
+    if (result != RT_EOK)
     {
-        LOG_E("device %s not find", PKG_WP_PLAY_DEVICE);
-        return - RT_ERROR;
+        LOG_E("open source %s failed", player->source->name);
+        return result;
     }
 
-    /* open file */
-    player->fp = fopen(player->uri, "rb");
-    if (player->fp == RT_NULL)
+    LOG_D("Information:");
+    LOG_D("samplerate %d", format.samplerate);
+    LOG_D("channels %d", format.channels);
+    LOG_D("sample bits width %d", format.samplebits);
+
+    /* float streams can't be played as is, wide ones are requantized when the device takes 16 bits */
+    if (format.encoding == WAVSOURCE_ENCODING_FLOAT &&
+        (format.samplebits != 32 || format.channels > PKG_WP_DITHER_CHANNELS_MAX))
     {
-        LOG_E("open file %s failed", player->uri);
-        result = -RT_ERROR;
+        LOG_E("float stream of %d bits %d channels can't be played", format.samplebits, format.channels);
+        result = -RT_EINVAL;
         goto __exit;
     }
 
-    /* open sound device */
-    result = rt_device_open(player->device, RT_DEVICE_OFLAG_WRONLY);
-    if (result != RT_EOK)
+    player->requantize = RT_FALSE;
+    player->samplebits = format.samplebits;
+    if (format.channels <= PKG_WP_DITHER_CHANNELS_MAX &&
+        ((format.encoding == WAVSOURCE_ENCODING_FLOAT && format.samplebits == 32) ||
+         (player->config.samplebits == 16 && (format.samplebits == 24 || format.samplebits == 32))))
     {
-        LOG_E("open %s device faield", PKG_WP_PLAY_DEVICE);
-        goto __exit;
+        player->requantize = RT_TRUE;
+        player->requantize_fn = wavpcm_requantize_select(format.samplebits,
+                                                         format.encoding == WAVSOURCE_ENCODING_FLOAT,
+                                                         format.channels, player->config.dither);
+        player->samplebits = 16;
+        wavpcm_dither_init(&player->dither, player->config.dither);
     }
 
-    LOG_D("open wavplayer, device %s", PKG_WP_PLAY_DEVICE);
-    /* read wavfile header information from file */
-    wavheader_read(&wav, player->fp);
+    rt_memset(&config, 0, sizeof(config));
+    config.samplerate = format.samplerate;
+    config.channels = format.channels;
+    config.samplebits = player->samplebits;
+
+    /* levels are computed on 16 bits pcm only */
+    wavmeter_reset(&player->meter, player->samplebits == 16 ? format.channels : 0);
+    player->format = format;
+#ifdef PKG_WP_USING_DSP
+    rt_mutex_take(player->lock, RT_WAITING_FOREVER);
+    wavdsp_chain_reset(player->stages);
+    rt_mutex_release(player->lock);
+#endif
 
-    LOG_D("Information:");
-    LOG_D("samplerate %d", wav.fmt_sample_rate);
-    LOG_D("channels %d", wav.fmt_channels);
-    LOG_D("sample bits width %d", wav.fmt_bit_per_sample);
+    result = wavplayer_device_open(player, &config);
+    if (result != RT_EOK)
+        goto __exit;
 
-    /* set sampletate,channels, samplebits */
-    caps.main_type = AUDIO_TYPE_OUTPUT;
-    caps.sub_type  = AUDIO_DSP_PARAM;
-    caps.udata.config.samplerate = wav.fmt_sample_rate;
-    caps.udata.config.channels = wav.fmt_channels;
-    caps.udata.config.samplebits = wav.fmt_bit_per_sample;
-    rt_device_control(player->device, AUDIO_CTL_CONFIGURE, &caps);
+    LOG_D("open wavplayer, device %s", player->device_name);
 
-    /* set volume according to configuration */
-    caps.main_type = AUDIO_TYPE_MIXER;
-    caps.sub_type  = AUDIO_MIXER_VOLUME;
-    caps.udata.value = player->volume;
-    rt_device_control(player->device, AUDIO_CTL_CONFIGURE, &caps);
+    /* start reading ahead */
+    result = wavplayer_io_start(player);
+    if (result != RT_EOK)
+    {
+        LOG_E("start file reader failed");
+        goto __exit;
+    }
 
     return RT_EOK;
 
 __exit:
-    if (player->fp)
-    {
-        fclose(player->fp);
-        player->fp = RT_NULL;
-    }
+    wavplayer_io_stop(player);
+    player->source->ops->close(player->source);
 
-    if (player->device)
-    {
-        rt_device_close(player->device);
-        player->device = RT_NULL;
-    }
+    /* a bad file doesn't end the grace period of a warm device */
+    if (player->dev_warm == RT_FALSE)
+        wavplayer_device_close(player);
 
     return result;
 }
@@ -290,21 +1612,41 @@ __exit:
 
 static void wavplayer_close(struct wavplayer *player)
 {
-    if (player->fp)
+    wavplayer_io_stop(player);
+    player->source->ops->close(player->source);
+
+    /* keep the device open with its current params for a grace period */
+    if (player->config.keepalive_time > 0 && player->dev_opened)
     {
-        fclose(player->fp);
-        player->fp = RT_NULL;
+        player->dev_warm = RT_TRUE;
+        player->dev_warm_tick = rt_tick_get() + rt_tick_from_millisecond(player->config.keepalive_time);
     }
-
-    if (player->device)
+    else
     {
-        rt_device_close(player->device);
-        player->device = RT_NULL;
+        wavplayer_device_close(player);
     }
 
     LOG_D("close wavplayer");
 }
 
+/* ticks to wait for the next request, the warm device is closed once its grace period is over */
+static rt_int32_t wavplayer_idle_timeout(struct wavplayer *player)
+{
+    rt_int32_t remain;
+
+    if (player->dev_warm == RT_FALSE)
+        return RT_WAITING_FOREVER;
+
+    remain = (rt_int32_t)(player->dev_warm_tick - rt_tick_get());
+    if (remain <= 0)
+    {
+        wavplayer_device_close(player);
+        return RT_WAITING_FOREVER;
+    }
+
+    return remain;
+}
+
 static int wavplayer_event_handler(struct wavplayer *player, int timeout)
 {
     int event;
@@ -326,34 +1668,86 @@ static int wavplayer_event_handler(struct wavplayer *player, int timeout)
     last_state = player->state;
 #endif
 
+    /* requests that don't match the current state are acked without effect */
+    event = PLAYER_EVENT_NONE;
     switch (msg.type)
     {
     case MSG_START:
+        WAVTRACE_INSTANT(WAVTRACE_EVENT_START, player->state);
         event = PLAYER_EVENT_PLAY;
         player->state = PLAYER_STATE_PLAYING;
+        /* a replaced start request that was never opened */
+        if (player->start_msg.data)
+        {
+            play_msg_drop(MSG_START, player->start_msg.data);
+            play_msg_ack(&player->start_msg, -RT_ERROR);
+        }
+        player->start_msg = msg;
+        /* acked by the player thread after the stream is opened */
+        msg.ack = RT_NULL;
         break;
 
     case MSG_STOP:
-        event = PLAYER_EVENT_STOP;
-        player->state = PLAYER_STATE_STOPED;
+        WAVTRACE_INSTANT(WAVTRACE_EVENT_STOP, player->state);
+        if (player->state != PLAYER_STATE_STOPED)
+        {
+            event = PLAYER_EVENT_STOP;
+            player->state = PLAYER_STATE_STOPED;
+        }
         break;
 
     case MSG_PAUSE:
-        event = PLAYER_EVENT_PAUSE;
-        player->state = PLAYER_STATE_PAUSED;
+        WAVTRACE_INSTANT(WAVTRACE_EVENT_PAUSE, player->state);
+        if (player->state == PLAYER_STATE_PLAYING)
+        {
+            event = PLAYER_EVENT_PAUSE;
+            player->state = PLAYER_STATE_PAUSED;
+            play_notify(player, PLAYER_NOTIFY_PAUSED, RT_EOK);
+        }
         break;
 
     case MSG_RESUME:
-        event = PLAYER_EVENT_RESUME;
-        player->state = PLAYER_STATE_PLAYING;
+        WAVTRACE_INSTANT(WAVTRACE_EVENT_RESUME, player->state);
+        if (player->state == PLAYER_STATE_PAUSED)
+        {
+            event = PLAYER_EVENT_RESUME;
+            player->state = PLAYER_STATE_PLAYING;
+            play_notify(player, PLAYER_NOTIFY_RESUMED, RT_EOK);
+        }
+        break;
+
+    case MSG_EXIT:
+        event = PLAYER_EVENT_EXIT;
+        player->state = PLAYER_STATE_STOPED;
+        player->exit_msg = msg;
+        /* acked by the player thread after it released everything */
+        msg.ack = RT_NULL;
+        break;
+
+    case MSG_CONFIG:
+        play_lock(player);
+        player->config = *(struct wavplayer_config *)msg.data;
+        play_unlock(player);
+        rt_free(msg.data);
+        rt_thread_control(player->tid, RT_THREAD_CTRL_CHANGE_PRIORITY, &player->config.thread_priority);
+        play_thread_bind(player->tid, player->config.sink_cpu);
+        if (player->io_tid)
+        {
+            rt_thread_control(player->io_tid, RT_THREAD_CTRL_CHANGE_PRIORITY, &player->config.io_thread_priority);
+            play_thread_bind(player->io_tid, player->config.io_cpu);
+        }
+        if (player->dsp_tid)
+        {
+            rt_thread_control(player->dsp_tid, RT_THREAD_CTRL_CHANGE_PRIORITY, &player->config.thread_priority);
+            play_thread_bind(player->dsp_tid, player->config.dsp_cpu);
+        }
         break;
 
     default:
-        event = PLAYER_EVENT_NONE;
         break;
     }
 
-    rt_completion_done(&player->ack);
+    play_msg_ack(&msg, RT_EOK);
 
 #if (DBG_LEVEL >= DBG_LOG)
     LOG_D("EVENT:%s, STATE:%s -> %s", event_str[event], state_str[last_state], state_str[player->state]);
@@ -364,116 +1758,358 @@ static int wavplayer_event_handler(struct wavplayer *player, int timeout)
 
 static void wavplayer_entry(void *parameter)
 {
+    struct wavplayer *player = (struct wavplayer *)parameter;
     rt_err_t result = RT_EOK;
-    rt_int32_t size;
+    struct play_block *block;
+    rt_uint64_t start;
+    rt_bool_t eos;
     int event;
 
-    player.buffer = rt_malloc(WP_BUFFER_SIZE);
-    if (player.buffer == RT_NULL)
-        return;
-    rt_memset(player.buffer, 0, WP_BUFFER_SIZE);
-
-    player.mq = rt_mq_create("wav_p", sizeof(struct play_msg), 10, RT_IPC_FLAG_FIFO);
-    if (player.mq == RT_NULL)
-        goto __exit;
-
-    player.lock = rt_mutex_create("wav_p", RT_IPC_FLAG_FIFO);
-    if (player.lock == RT_NULL)
-        goto __exit;
-
-    player.volume = WP_VOLUME_DEFAULT;
-
-    while (1)
+    event = PLAYER_EVENT_NONE;
+    while (event != PLAYER_EVENT_EXIT)
     {
-        /* wait play event forever */
-        event = wavplayer_event_handler(&player, RT_WAITING_FOREVER);
+        /* wait play event, unless a new stream replaced the last one */
+        if (event != PLAYER_EVENT_PLAY)
+            event = wavplayer_event_handler(player, wavplayer_idle_timeout(player));
         if (event != PLAYER_EVENT_PLAY)
             continue;
 
+        /* the stream of the start request replaces the last one */
+#ifdef PKG_WP_USING_CROSSFADE
+        rt_mutex_take(player->xfade_lock, RT_WAITING_FOREVER);
+        player->xfade = RT_NULL;
+        rt_mutex_release(player->xfade_lock);
+#endif
+        play_lock(player);
+        if (player->source && player->source->autodelete)
+            wavsource_delete(player->source);
+        player->source = (struct wavsource *)player->start_msg.data;
+        play_unlock(player);
+        player->start_msg.data = RT_NULL;
+#ifdef PKG_WP_USING_CROSSFADE
+        play_crossfade_wrap(player);
+#endif
+
         /* open wavplayer */
-        result = wavplayer_open(&player);
+        WAVTRACE_BEGIN(WAVTRACE_EVENT_OPEN, 0);
+        result = wavplayer_open(player);
+        WAVTRACE_END(WAVTRACE_EVENT_OPEN, (rt_uint32_t)result);
+        play_msg_ack(&player->start_msg, result);
         if (result != RT_EOK)
         {
-            player.state = PLAYER_STATE_STOPED;
+            event = PLAYER_EVENT_NONE;
+            player->state = PLAYER_STATE_STOPED;
             LOG_I("open wav player failed");
+            play_notify(player, PLAYER_NOTIFY_ERROR, result);
             continue;
         }
 
-        LOG_I("play start, uri=%s", player.uri);
+        LOG_I("play start, uri=%s", player->source->name);
+        play_notify(player, PLAYER_NOTIFY_STARTED, RT_EOK);
+        eos = RT_FALSE;
         while (1)
         {
-            event = wavplayer_event_handler(&player, RT_WAITING_NO);
+            event = wavplayer_event_handler(player, RT_WAITING_NO);
 
             switch (event)
             {
             case PLAYER_EVENT_NONE:
             {
-                /* read raw data from file stream */
-                size = fread(player.buffer, WP_BUFFER_SIZE, 1, player.fp);
-                if (size != 1)
+                /* take raw data read ahead from file stream */
+                block = play_block_get(player);
+                if (block->length == 0)
                 {
                     /* FILE END*/
-                    player.state = PLAYER_STATE_STOPED;
+                    WAVTRACE_INSTANT(WAVTRACE_EVENT_EOS, 0);
+                    player->state = PLAYER_STATE_STOPED;
+                    eos = RT_TRUE;
                 }
                 else
                 {
+                    /* the pipeline processed it already */
+                    if (!player->pipeline)
+                    {
+                        start = play_clock_us();
+                        wavplayer_block_process(player, block);
+                        player->busy[PLAY_THREAD_SINK] += play_clock_us() - start;
+                    }
+
                     /*witte data to sound device*/
-                    rt_device_write(player.device, 0, player.buffer, WP_BUFFER_SIZE);
+                    WAVTRACE_BEGIN(WAVTRACE_EVENT_WRITE, 0);
+                    rt_device_write(player->device, 0, block->out, block->out_length);
+                    WAVTRACE_END(WAVTRACE_EVENT_WRITE, block->out_length);
+                    player->write_wakeups++;
                 }
+                play_block_put(player, block);
                 break;
             }
 
             case PLAYER_EVENT_PAUSE:
             {
-                /* wait resume or stop event forever */
-                event = wavplayer_event_handler(&player, RT_WAITING_FOREVER);
+                /* wait resume, stop or play event forever */
+                while (player->state == PLAYER_STATE_PAUSED)
+                    event = wavplayer_event_handler(player, RT_WAITING_FOREVER);
             }
 
             default:
                 break;
             }
 
-            if (player.state == PLAYER_STATE_STOPED)
+            if (player->state == PLAYER_STATE_STOPED || event == PLAYER_EVENT_PLAY)
                 break;
         }
 
         /* close wavplayer */
-        wavplayer_close(&player);
+        wavplayer_close(player);
         LOG_I("play end");
+        play_notify(player, eos ? PLAYER_NOTIFY_EOS : PLAYER_NOTIFY_STOPPED, RT_EOK);
     }
 
+    /* deleted, release the warm device and hand the instance back */
+    wavplayer_device_close(player);
+    play_msg_flush(player);
+    play_msg_ack(&player->exit_msg, RT_EOK);
+}
+
+wavplayer_t wavplayer_create(const char *device_name, const struct wavplayer_config *config)
+{
+    struct wavplayer *player;
+
+    if (device_name == RT_NULL)
+        return RT_NULL;
+
+    if (config == RT_NULL)
+        config = &config_default;
+    if (!play_config_check(config))
+        return RT_NULL;
+
+    player = rt_malloc(sizeof(struct wavplayer));
+    if (player == RT_NULL)
+        return RT_NULL;
+    rt_memset(player, 0, sizeof(struct wavplayer));
+
+    rt_strncpy(player->device_name, device_name, RT_NAME_MAX);
+    player->config = *config;
+    player->volume = WP_VOLUME_DEFAULT;
+
+    player->mq = rt_mq_create("wav_p", sizeof(struct play_msg), WP_MSG_SIZE, RT_IPC_FLAG_FIFO);
+    if (player->mq == RT_NULL)
+        goto __exit;
+
+    player->lock = rt_mutex_create("wav_p", RT_IPC_FLAG_FIFO);
+    if (player->lock == RT_NULL)
+        goto __exit;
+
+#ifdef PKG_WP_USING_CROSSFADE
+    player->xfade_lock = rt_mutex_create("wp_xfade", RT_IPC_FLAG_FIFO);
+    if (player->xfade_lock == RT_NULL)
+        goto __exit;
+#endif
+
+    player->tid = rt_thread_create("wav_p",
+                                   wavplayer_entry,
+                                   player,
+                                   PKG_WP_THREAD_STACK_SIZE,
+                                   player->config.thread_priority, 10);
+    if (player->tid == RT_NULL)
+        goto __exit;
+
+    play_thread_bind(player->tid, player->config.sink_cpu);
+    rt_thread_startup(player->tid);
+
+    return player;
+
 __exit:
-    if (player.buffer)
-    {
-        rt_free(player.buffer);
-        player.buffer = RT_NULL;
-    }
+    if (player->mq)
+        rt_mq_delete(player->mq);
 
-    if (player.mq)
-    {
-        rt_mq_delete(player.mq);
-        player.mq = RT_NULL;
-    }
+    if (player->lock)
+        rt_mutex_delete(player->lock);
 
-    if (player.lock)
-    {
-        rt_mutex_delete(player.lock);
-        player.lock = RT_NULL;
-    }
+#ifdef PKG_WP_USING_CROSSFADE
+    if (player->xfade_lock)
+        rt_mutex_delete(player->xfade_lock);
+#endif
+
+    rt_free(player);
+
+    return RT_NULL;
 }
 
+int wavplayer_delete(wavplayer_t player)
+{
+    int result;
+
+    RT_ASSERT(player != RT_NULL);
 
-int wavplayer_init(void)
+    /* the player thread stops the stream and exits */
+    result = play_request(player, MSG_EXIT, RT_NULL, RT_TRUE);
+    if (result != RT_EOK)
+        return result;
+
+    if (player == player_default)
+        player_default = RT_NULL;
+
+    rt_mq_delete(player->mq);
+    rt_mutex_delete(player->lock);
+#ifdef PKG_WP_USING_CROSSFADE
+    rt_mutex_delete(player->xfade_lock);
+#endif
+    if (player->source && player->source->autodelete)
+        wavsource_delete(player->source);
+#ifdef PKG_WP_USING_DSP
+    wavpool_free(player->dsp_work);
+#endif
+    rt_free(player);
+
+    return RT_EOK;
+}
+
+wavplayer_t wavplayer_default(void)
 {
-    rt_thread_t tid;
+    return player_default;
+}
 
-    tid = rt_thread_create("wav_p",
-                           wavplayer_entry,
-                           RT_NULL,
-                           WP_THREAD_STATCK_SIZE,
-                           WP_THREAD_PRIORITY, 10);
-    if (tid)
-        rt_thread_startup(tid);
+int wavplayer_play_next(char *uri)
+{
+    return player_default ? wavplayer_inst_play_next(player_default, uri) : -RT_ERROR;
+}
+
+int wavplayer_play_async(char *uri)
+{
+    return player_default ? wavplayer_inst_play_async(player_default, uri) : -RT_ERROR;
+}
+
+int wavplayer_play_source(struct wavsource *source)
+{
+    return player_default ? wavplayer_inst_play_source(player_default, source) : -RT_ERROR;
+}
+
+int wavplayer_play_source_async(struct wavsource *source)
+{
+    return player_default ? wavplayer_inst_play_source_async(player_default, source) : -RT_ERROR;
+}
+
+int wavplayer_stop_async(void)
+{
+    return player_default ? wavplayer_inst_stop_async(player_default) : -RT_ERROR;
+}
+
+int wavplayer_pause_async(void)
+{
+    return player_default ? wavplayer_inst_pause_async(player_default) : -RT_ERROR;
+}
+
+int wavplayer_resume_async(void)
+{
+    return player_default ? wavplayer_inst_resume_async(player_default) : -RT_ERROR;
+}
+
+int wavplayer_play(char *uri)
+{
+    return player_default ? wavplayer_inst_play(player_default, uri) : -RT_ERROR;
+}
+
+int wavplayer_stop(void)
+{
+    return player_default ? wavplayer_inst_stop(player_default) : -RT_ERROR;
+}
+
+int wavplayer_pause(void)
+{
+    return player_default ? wavplayer_inst_pause(player_default) : -RT_ERROR;
+}
+
+int wavplayer_resume(void)
+{
+    return player_default ? wavplayer_inst_resume(player_default) : -RT_ERROR;
+}
+
+int wavplayer_callback_set(wavplayer_callback_t callback, void *user_data)
+{
+    return player_default ? wavplayer_inst_callback_set(player_default, callback, user_data) : -RT_ERROR;
+}
+
+int wavplayer_notify_set(rt_event_t event)
+{
+    return player_default ? wavplayer_inst_notify_set(player_default, event) : -RT_ERROR;
+}
+
+int wavplayer_volume_set(int volume)
+{
+    return player_default ? wavplayer_inst_volume_set(player_default, volume) : -RT_ERROR;
+}
+
+int wavplayer_volume_get(void)
+{
+    return player_default ? wavplayer_inst_volume_get(player_default) : 0;
+}
+
+int wavplayer_state_get(void)
+{
+    return player_default ? wavplayer_inst_state_get(player_default) : PLAYER_STATE_STOPED;
+}
+
+char *wavplayer_uri_get(void)
+{
+    return player_default ? wavplayer_inst_uri_get(player_default) : RT_NULL;
+}
+
+int wavplayer_config_get(struct wavplayer_config *config)
+{
+    return player_default ? wavplayer_inst_config_get(player_default, config) : -RT_ERROR;
+}
+
+int wavplayer_config_set(const struct wavplayer_config *config)
+{
+    return player_default ? wavplayer_inst_config_set(player_default, config) : -RT_ERROR;
+}
+
+int wavplayer_underrun_get(void)
+{
+    return player_default ? wavplayer_inst_underrun_get(player_default) : 0;
+}
+
+int wavplayer_meter_get(struct wavmeter_level *level)
+{
+    return player_default ? wavplayer_inst_meter_get(player_default, level) : -RT_ERROR;
+}
+
+int wavplayer_storage_hook_set(wavplayer_storage_hook_t hook, void *user_data)
+{
+    return player_default ? wavplayer_inst_storage_hook_set(player_default, hook, user_data) : -RT_ERROR;
+}
+
+int wavplayer_power_stat_get(struct wavplayer_power_stat *stat)
+{
+    return player_default ? wavplayer_inst_power_stat_get(player_default, stat) : -RT_ERROR;
+}
+
+int wavplayer_cpu_stat_get(struct wavplayer_cpu_stat *stat)
+{
+    return player_default ? wavplayer_inst_cpu_stat_get(player_default, stat) : -RT_ERROR;
+}
+
+#ifdef PKG_WP_USING_DSP
+int wavplayer_stage_add(struct wavdsp_stage *stage)
+{
+    return player_default ? wavplayer_inst_stage_add(player_default, stage) : -RT_ERROR;
+}
+
+int wavplayer_stage_remove(struct wavdsp_stage *stage)
+{
+    return player_default ? wavplayer_inst_stage_remove(player_default, stage) : -RT_ERROR;
+}
+#endif
+
+int wavplayer_init(void)
+{
+    player_default = wavplayer_create(PKG_WP_PLAY_DEVICE, RT_NULL);
+    if (player_default == RT_NULL)
+    {
+        LOG_E("create default wav player failed");
+        return -RT_ERROR;
+    }
 
     return RT_EOK;
 }
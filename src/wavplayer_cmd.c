@@ -11,6 +11,9 @@
 #include <rtdevice.h>
 #include <optparse.h>
 #include <wavplayer.h>
+#include <wavpool.h>
+#include <wavio.h>
+#include <wavsource.h>
 
 #include <stdlib.h>
 
@@ -23,6 +26,8 @@ enum WAVPLAYER_ACTTION
     WAVPLAYER_ACTION_RESUME = 4,
     WAVPLAYER_ACTION_VOLUME = 5,
     WAVPLAYER_ACTION_DUMP   = 6,
+    WAVPLAYER_ACTION_MIX    = 7,
+    WAVPLAYER_ACTION_NEXT   = 8,
 };
 
 struct wavplay_args
@@ -30,6 +35,7 @@ struct wavplay_args
     int action;
     char *uri;
     int volume;
+    int io_backend;                         /* -1 keeps the configuration */
 };
 
 static const char *state_str[] =
@@ -48,6 +54,9 @@ static struct optparse_long opts[] =
     {"resume", 'r', OPTPARSE_NONE    },     /* 恢复 */
     {"volume", 'v', OPTPARSE_REQUIRED},     /* 音量 */
     {"dump",   'd', OPTPARSE_NONE    },     /* 状态 */
+    {"io",     'i', OPTPARSE_REQUIRED},     /* 文件读取方式 */
+    {"mix",    'm', OPTPARSE_REQUIRED},     /* 混音播放 */
+    {"next",   'n', OPTPARSE_REQUIRED},     /* 下一首 */
     { NULL,  0,  OPTPARSE_NONE    }
 };
 
@@ -62,14 +71,54 @@ static void usage(void)
     rt_kprintf("  -r,     --resume                   Resume the music.\n");
     rt_kprintf("  -v lvl, --volume=lvl               Change the volume(0~99).\n");
     rt_kprintf("  -d,     --dump                     Dump play relevant information.\n");
+    rt_kprintf("  -i io,  --io=io                    Read files with stdio, fd, direct or mmap.\n");
+#ifdef PKG_WP_USING_MIX
+    rt_kprintf("  -m URI, --mix=URI                  Play URI over the mix playing, ducking it.\n");
+#endif
+    rt_kprintf("  -n URI, --next=URI                 Play URI after the current music.\n");
 }
 
 static void dump_status(void)
 {
+    struct wavmeter_level level;
+    struct wavplayer_power_stat power;
+    struct wavplayer_cpu_stat cpu;
+#ifdef PKG_WP_USING_POOL
+    struct wavpool_stat stat;
+#endif
+    int i;
+
     rt_kprintf("\nwavplayer status:\n");
     rt_kprintf("uri     - %s\n", wavplayer_uri_get());
     rt_kprintf("status  - %s\n", state_str[wavplayer_state_get()]);
     rt_kprintf("volume  - %d\n", wavplayer_volume_get());
+    rt_kprintf("underrun- %d\n", wavplayer_underrun_get());
+
+    wavplayer_meter_get(&level);
+    for (i = 0; i < level.channels && level.blocks > 0; i++)
+        rt_kprintf("ch%d     - peak %5d rms %5d\n", i, level.peak[i], level.rms[i]);
+
+    wavplayer_power_stat_get(&power);
+    if (power.elapsed > 0)
+    {
+        rt_kprintf("wakeups - io %d/s, write %d/s\n",
+                   (int)((rt_uint64_t)power.io_wakeups * 1000 / power.elapsed),
+                   (int)((rt_uint64_t)power.write_wakeups * 1000 / power.elapsed));
+        rt_kprintf("storage - active %d of %d ms\n", power.storage_active, power.elapsed);
+    }
+
+    wavplayer_cpu_stat_get(&cpu);
+    if (cpu.elapsed > 0)
+    {
+        rt_kprintf("cpu     - io %d.%d%%, dsp %d.%d%%, sink %d.%d%%\n",
+                   cpu.io / 10, cpu.io % 10, cpu.dsp / 10, cpu.dsp % 10, cpu.sink / 10, cpu.sink % 10);
+    }
+
+#ifdef PKG_WP_USING_POOL
+    wavpool_stat_get(&stat);
+    rt_kprintf("pool    - %d/%d blocks of %d bytes, max %d, heap fallback %d\n",
+               stat.used, stat.block_count, stat.block_size, stat.used_max, stat.fallback);
+#endif
 }
 
 int wavplay_args_prase(int argc, char *argv[], struct wavplay_args *play_args)
@@ -127,6 +176,24 @@ int wavplay_args_prase(int argc, char *argv[], struct wavplay_args *play_args)
             play_args->action = WAVPLAYER_ACTION_DUMP;
             break;
 
+        case 'm':   /* 混音播放 */
+            play_args->action = WAVPLAYER_ACTION_MIX;
+            play_args->uri = options.optarg;
+            action_cnt++;
+            break;
+
+        case 'n':   /* 下一首 */
+            play_args->action = WAVPLAYER_ACTION_NEXT;
+            play_args->uri = options.optarg;
+            action_cnt++;
+            break;
+
+        case 'i':   /* 读取方式 */
+            play_args->io_backend = wavio_backend_find(options.optarg);
+            if (play_args->io_backend < 0)
+                result = -RT_EINVAL;
+            break;
+
         default:
             result = -RT_EINVAL;
             break;
@@ -143,11 +210,52 @@ int wavplay_args_prase(int argc, char *argv[], struct wavplay_args *play_args)
     return result;
 }
 
+#ifdef PKG_WP_USING_MIX
+/* the player plays the mix as long as it reports its name */
+static struct wavsource *mix_source;
+
+static int play_mix(const char *uri)
+{
+    struct wavsource *input;
+    char *name;
+    int state;
+
+    input = wavsource_file_create(uri);
+    if (input == RT_NULL)
+        return -RT_ENOMEM;
+
+    /* a new mix starts with the first file as the lowest priority */
+    state = wavplayer_state_get();
+    name = wavplayer_uri_get();
+    if (mix_source && state != PLAYER_STATE_STOPED && name && rt_strcmp(name, "mix") == 0)
+        return wavsource_mix_add(mix_source, input, 1);
+
+    mix_source = wavsource_mix_create(RT_NULL);
+    if (mix_source == RT_NULL)
+    {
+        wavsource_delete(input);
+        return -RT_ENOMEM;
+    }
+    mix_source->autodelete = RT_TRUE;
+
+    if (wavsource_mix_add(mix_source, input, 0) != RT_EOK)
+    {
+        wavsource_delete(mix_source);
+        mix_source = RT_NULL;
+        return -RT_ERROR;
+    }
+
+    return wavplayer_play_source(mix_source);
+}
+#endif
+
 int wav_player(int argc, char *argv[])
 {
     int result = RT_EOK;
     struct wavplay_args play_args = {0};
+    struct wavplayer_config config;
 
+    play_args.io_backend = -1;
     result = wavplay_args_prase(argc, argv, &play_args);
     if (result != RT_EOK)
     {
@@ -155,6 +263,13 @@ int wav_player(int argc, char *argv[])
         return result;
     }
 
+    /* the backend applies from the next file played */
+    if (play_args.io_backend >= 0 && wavplayer_config_get(&config) == RT_EOK)
+    {
+        config.io_backend = play_args.io_backend;
+        wavplayer_config_set(&config);
+    }
+
     switch (play_args.action)
     {
     case WAVPLAYER_ACTION_HELP:
@@ -165,6 +280,10 @@ int wav_player(int argc, char *argv[])
         wavplayer_play(play_args.uri);
         break;
 
+    case WAVPLAYER_ACTION_NEXT:
+        wavplayer_play_next(play_args.uri);
+        break;
+
     case WAVPLAYER_ACTION_STOP:
         wavplayer_stop();
         break;
@@ -185,6 +304,12 @@ int wav_player(int argc, char *argv[])
         dump_status();
         break;
 
+#ifdef PKG_WP_USING_MIX
+    case WAVPLAYER_ACTION_MIX:
+        result = play_mix(play_args.uri);
+        break;
+#endif
+
     default:
         result = -RT_ERROR;
         break;
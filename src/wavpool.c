@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <wavpool.h>
+
+#ifdef PKG_WP_USING_POOL
+
+#define POOL_BLOCK_SIZE      RT_ALIGN(PKG_WP_POOL_BLOCK_SIZE, PKG_WP_POOL_ALIGN)
+
+/* the blocks can be placed in a DMA capable or tightly coupled memory by the linker script */
+#ifdef PKG_WP_POOL_SECTION
+rt_section(PKG_WP_POOL_SECTION)
+#endif
+rt_align(PKG_WP_POOL_ALIGN) static rt_uint8_t pool_memory[PKG_WP_POOL_BLOCK_COUNT][POOL_BLOCK_SIZE];
+
+/* stack of free block indexes, get and put are O(1) */
+static rt_uint16_t pool_free[PKG_WP_POOL_BLOCK_COUNT];
+static rt_uint16_t pool_top;
+static rt_bool_t pool_ready;
+static struct wavpool_stat pool_stat;
+
+static void wavpool_init(void)
+{
+    int i;
+
+    for (i = 0; i < PKG_WP_POOL_BLOCK_COUNT; i++)
+        pool_free[i] = PKG_WP_POOL_BLOCK_COUNT - 1 - i;
+    pool_top = PKG_WP_POOL_BLOCK_COUNT;
+
+    pool_stat.block_size = POOL_BLOCK_SIZE;
+    pool_stat.block_count = PKG_WP_POOL_BLOCK_COUNT;
+    pool_ready = RT_TRUE;
+}
+
+void *wavpool_malloc(rt_size_t size)
+{
+    void *ptr = RT_NULL;
+
+    rt_enter_critical();
+    if (!pool_ready)
+        wavpool_init();
+
+    if (size <= POOL_BLOCK_SIZE && pool_top > 0)
+    {
+        ptr = pool_memory[pool_free[--pool_top]];
+        pool_stat.used++;
+        if (pool_stat.used > pool_stat.used_max)
+            pool_stat.used_max = pool_stat.used;
+    }
+    else
+    {
+        pool_stat.fallback++;
+    }
+    rt_exit_critical();
+
+    if (ptr == RT_NULL)
+        ptr = rt_malloc(size);
+
+    return ptr;
+}
+
+void wavpool_free(void *ptr)
+{
+    rt_uint8_t *block = (rt_uint8_t *)ptr;
+
+    if (block == RT_NULL)
+        return;
+
+    if (block < pool_memory[0] || block >= pool_memory[PKG_WP_POOL_BLOCK_COUNT])
+    {
+        rt_free(ptr);
+        return;
+    }
+
+    RT_ASSERT((block - pool_memory[0]) % POOL_BLOCK_SIZE == 0);
+
+    rt_enter_critical();
+    pool_free[pool_top++] = (block - pool_memory[0]) / POOL_BLOCK_SIZE;
+    pool_stat.used--;
+    rt_exit_critical();
+}
+
+void wavpool_stat_get(struct wavpool_stat *stat)
+{
+    rt_enter_critical();
+    if (!pool_ready)
+        wavpool_init();
+    *stat = pool_stat;
+    rt_exit_critical();
+}
+
+#endif /* PKG_WP_USING_POOL */
@@ -10,21 +10,74 @@
 #include <rtthread.h>
 #include <rtdevice.h>
 #include <wavhdr.h>
+#include <wavio.h>
+#include <wavpcm.h>
+#include <wavpool.h>
 #include <wavrecorder.h>
+#include <wavtrace.h>
+#ifdef PKG_WP_USING_ASRC
+#include <wavasrc.h>
+#endif
+
+#include <string.h>
 
 #define DBG_TAG              "WAV_RECORDER"
 #define DBG_LVL              DBG_INFO
 #include <rtdbg.h>
 
+#ifndef PKG_WP_RECORD_BUFFER_SIZE
+#define PKG_WP_RECORD_BUFFER_SIZE (2048)
+#endif
+#ifndef PKG_WP_RECORD_STACK_SIZE
+#define PKG_WP_RECORD_STACK_SIZE (2048)
+#endif
+#ifndef PKG_WP_RECORD_PRIORITY
+#define PKG_WP_RECORD_PRIORITY (19)
+#endif
+#ifndef PKG_WP_RECORD_CHANNELS_MAX
+#define PKG_WP_RECORD_CHANNELS_MAX (8)
+#endif
+#ifdef PKG_WP_USING_METER
+#define WR_METER_DEFAULT (1)
+#else
+#define WR_METER_DEFAULT (0)
+#endif
+
 struct recorder
 {
     rt_device_t device;
     struct wavrecord_info info;
+    struct wavrecorder_config config;
     struct rt_event *event;
     struct rt_completion ack;
     rt_uint8_t *buffer;
-    FILE *fp;
+    struct wavio io;
     rt_bool_t activated;
+    int sample_bytes;                       /* bytes of a sample read from the sound device */
+    /* converts samples in place to the encoding of the file, returns the bytes to write */
+    rt_size_t (*encode)(struct recorder *record, void *data, rt_size_t samples);
+
+    /* one file per selected channel */
+    int split_count;
+    rt_uint8_t split_map[PKG_WP_RECORD_CHANNELS_MAX];
+    void *split_buffer[PKG_WP_RECORD_CHANNELS_MAX];
+    struct wavio split_io[PKG_WP_RECORD_CHANNELS_MAX];
+
+    /* levels of the captured blocks, read without stopping the record */
+    struct wavmeter meter;
+
+    /* memory capture instead of files */
+    rt_bool_t capture;
+    struct wavcapture_info capture_info;
+    rt_uint32_t block_size;                 /* bytes read from the sound device each time */
+    volatile rt_uint32_t overrun;
+#ifdef PKG_WP_USING_ASRC
+    /* follows the clock of the ring consumer */
+    struct wavasrc *asrc;
+    rt_int16_t *asrc_buffer;
+    rt_size_t asrc_frames;
+    volatile rt_int32_t drift;              /* ppm of the last correction */
+#endif
 };
 
 enum RECORD_EVENT
@@ -33,9 +86,144 @@ enum RECORD_EVENT
     RECORD_EVENT_START = 0x02,
 };
 
-#define WR_BUFFER_SIZE (2048)
+static struct recorder record =
+{
+    .config =
+    {
+        .buffer_size       = PKG_WP_RECORD_BUFFER_SIZE,
+        .thread_stack_size = PKG_WP_RECORD_STACK_SIZE,
+        .thread_priority   = PKG_WP_RECORD_PRIORITY,
+        .meter             = WR_METER_DEFAULT,
+    },
+};
+
+static void wavrecorder_close(struct recorder *record);
+
+/* "rec.wav" -> "rec_ch2.wav" */
+static char *wavrecorder_split_uri(const char *uri, int channel)
+{
+    const char *ext;
+    char *name;
+    rt_size_t stem, size;
+
+    ext = strrchr(uri, '.');
+    if (ext == RT_NULL || strchr(ext, '/') != RT_NULL)
+        ext = uri + rt_strlen(uri);
+    stem = ext - uri;
+
+    size = rt_strlen(uri) + sizeof("_ch255");
+    name = rt_malloc(size);
+    if (name == RT_NULL)
+        return RT_NULL;
+
+    rt_memcpy(name, uri, stem);
+    rt_snprintf(name + stem, size - stem, "_ch%d%s", channel, ext);
+
+    return name;
+}
+
+static rt_err_t wavrecorder_split_open(struct recorder *record)
+{
+    rt_size_t frames;
+    char *name;
+    int c, i;
+
+    record->split_count = 0;
+    for (c = 0; c < record->info.channels; c++)
+    {
+        if (record->info.split_mask & (1UL << c))
+            record->split_map[record->split_count++] = c;
+    }
+
+    frames = record->block_size / (record->info.channels * record->sample_bytes);
+    for (i = 0; i < record->split_count; i++)
+    {
+        record->split_buffer[i] = wavpool_malloc(frames * record->sample_bytes);
+        if (record->split_buffer[i] == RT_NULL)
+        {
+            LOG_E("malloc split buffer for recorder failed");
+            return -RT_ENOMEM;
+        }
+
+        name = wavrecorder_split_uri(record->info.uri, record->split_map[i]);
+        if (name == RT_NULL)
+            return -RT_ENOMEM;
+
+        if (wavio_open(&record->split_io[i], name, WAVIO_MODE_WRITE, record->info.io_backend) != RT_EOK)
+        {
+            LOG_E("open file %s failed", name);
+            rt_free(name);
+            return -RT_ERROR;
+        }
+        rt_free(name);
+    }
+
+    return RT_EOK;
+}
+
+static void wavrecorder_split_close(struct recorder *record)
+{
+    int i;
+
+    for (i = 0; i < PKG_WP_RECORD_CHANNELS_MAX; i++)
+    {
+        if (record->split_buffer[i])
+        {
+            wavpool_free(record->split_buffer[i]);
+            record->split_buffer[i] = RT_NULL;
+        }
+
+        wavio_close(&record->split_io[i]);
+    }
+    record->split_count = 0;
+}
+
+#ifdef PKG_WP_USING_ASRC
+static rt_err_t wavrecorder_asrc_open(struct recorder *record)
+{
+    rt_size_t frames = record->block_size / (record->info.channels * record->sample_bytes);
+
+    if (record->info.samplebits != 16 || record->info.channels > PKG_WP_ASRC_CHANNELS_MAX)
+    {
+        LOG_E("drift compensation needs 16 bits and up to %d channels", PKG_WP_ASRC_CHANNELS_MAX);
+        return -RT_EINVAL;
+    }
+
+    /* room for a block stretched by the largest correction */
+    record->asrc_frames = frames + frames / 512 + 4;
+    record->asrc = rt_malloc(sizeof(struct wavasrc));
+    record->asrc_buffer = wavpool_malloc(record->asrc_frames * record->info.channels * sizeof(rt_int16_t));
+    if (record->asrc == RT_NULL || record->asrc_buffer == RT_NULL)
+    {
+        LOG_E("malloc drift compensation for recorder failed");
+        return -RT_ENOMEM;
+    }
 
-static struct recorder record;
+    record->drift = 0;
+
+    return wavasrc_init(record->asrc, record->info.samplerate, record->info.channels);
+}
+#endif
+
+/* convert samples in place to the encoding of the file, returns the bytes to write */
+static rt_size_t wavrecorder_encode_pcm(struct recorder *record, void *data, rt_size_t samples)
+{
+    return samples * record->sample_bytes;
+}
+
+static rt_size_t wavrecorder_encode_pack24(struct recorder *record, void *data, rt_size_t samples)
+{
+    wavpcm_pack24((rt_int32_t *)data, (rt_uint8_t *)data, samples);
+
+    return samples * 3;
+}
+
+static rt_size_t wavrecorder_encode_float(struct recorder *record, void *data, rt_size_t samples)
+{
+    wavpcm_float32((rt_int32_t *)data, (float *)data, samples);
+
+    return samples * sizeof(float);
+}
 
 static rt_err_t wavrecorder_open(struct recorder *record)
 {
@@ -49,22 +237,55 @@ static rt_err_t wavrecorder_open(struct recorder *record)
     }
 
     /* malloc internal buffer */
-    record->buffer = rt_malloc(WR_BUFFER_SIZE);
+    record->buffer = wavpool_malloc(record->block_size);
     if (record->buffer == RT_NULL)
     {
         result = -RT_ENOMEM;
         LOG_E("malloc internal buffer for recorder failed");
         goto __exit;
     }
-    rt_memset(record->buffer, 0, WR_BUFFER_SIZE);
+    rt_memset(record->buffer, 0, record->block_size);
 
-    /* open file */
-    record->fp = fopen(record->info.uri, "wb+");
-    if (record->fp == RT_NULL)
+    /* the encoding is fixed for the whole record, blocks don't choose it again */
+    switch (record->info.encoding)
     {
-        result = -RT_ERROR;
-        LOG_E("open file %s failed", record->info.uri);
-        goto __exit;
+    case WAVRECORD_ENCODING_PACKED24:
+        record->encode = wavrecorder_encode_pack24;
+        break;
+
+    case WAVRECORD_ENCODING_FLOAT:
+        record->encode = wavrecorder_encode_float;
+        break;
+
+    default:
+        record->encode = wavrecorder_encode_pcm;
+        break;
+    }
+
+#ifdef PKG_WP_USING_ASRC
+    if (record->capture && record->capture_info.ring && record->capture_info.ring_target)
+    {
+        result = wavrecorder_asrc_open(record);
+        if (result != RT_EOK)
+            goto __exit;
+    }
+#endif
+
+    /* open file, or one file per selected channel, captures stay in memory */
+    if (record->info.split_mask)
+    {
+        result = wavrecorder_split_open(record);
+        if (result != RT_EOK)
+            goto __exit;
+    }
+    else if (record->capture == RT_FALSE)
+    {
+        if (wavio_open(&record->io, record->info.uri, WAVIO_MODE_WRITE, record->info.io_backend) != RT_EOK)
+        {
+            result = -RT_ERROR;
+            LOG_E("open file %s failed", record->info.uri);
+            goto __exit;
+        }
     }
 
     /* open micphone device */
@@ -73,6 +294,7 @@ static rt_err_t wavrecorder_open(struct recorder *record)
     {
         result = -RT_ERROR;
         LOG_E("open %s device faield", PKG_WP_RECORD_DEVICE);
+        record->device = RT_NULL;
         goto __exit;
     }
 
@@ -87,17 +309,35 @@ static rt_err_t wavrecorder_open(struct recorder *record)
     return RT_EOK;
 
 __exit:
+    wavrecorder_close(record);
+
+    return result;
+}
+
+static void wavrecorder_close(struct recorder *record)
+{
     if (record->buffer)
     {
-        rt_free(record->buffer);
+        wavpool_free(record->buffer);
         record->buffer = RT_NULL;
     }
 
-    if (record->fp)
+    wavio_close(&record->io);
+
+    wavrecorder_split_close(record);
+
+#ifdef PKG_WP_USING_ASRC
+    if (record->asrc)
     {
-        fclose(record->fp);
-        record->fp = RT_NULL;
+        rt_free(record->asrc);
+        record->asrc = RT_NULL;
     }
+    if (record->asrc_buffer)
+    {
+        wavpool_free(record->asrc_buffer);
+        record->asrc_buffer = RT_NULL;
+    }
+#endif
 
     if (record->device)
     {
@@ -110,44 +350,132 @@ __exit:
         rt_event_delete(record->event);
         record->event = RT_NULL;
     }
+}
 
-    return result;
+/* 24 bits samples are handed out in the upper part of their containers, like wav keeps them */
+static void wavrecorder_justify(struct recorder *record, rt_size_t size)
+{
+#ifdef PKG_WP_RECORD_24BIT_RIGHT_JUSTIFIED
+    rt_int32_t *sample = (rt_int32_t *)record->buffer;
+    rt_size_t i;
+
+    if (record->info.samplebits == 24)
+    {
+        for (i = 0; i < size / sizeof(rt_int32_t); i++)
+            sample[i] = (rt_int32_t)((rt_uint32_t)sample[i] << 8);
+    }
+#endif
 }
 
-void wavrecorder_close(struct recorder *record)
+/* hand the captured block to the ring buffer and the callback, it is never copied otherwise */
+static void wavrecorder_capture(struct recorder *record, rt_size_t size)
 {
-    if (record->buffer)
+    struct wavcapture_info *info = &record->capture_info;
+    void *data = record->buffer;
+#ifdef PKG_WP_USING_ASRC
+    rt_size_t frame = record->info.channels * sizeof(rt_int16_t), frames = 0;
+
+    /* resampled to the rate the ring is drained at */
+    if (record->asrc)
     {
-        rt_free(record->buffer);
-        record->buffer = RT_NULL;
+        frames = wavasrc_process(record->asrc, (const rt_int16_t *)record->buffer, size / frame,
+                                 record->asrc_buffer, record->asrc_frames, RT_NULL);
+        data = record->asrc_buffer;
+        size = frames * frame;
     }
+#endif
 
-    if (record->fp)
+    /* whole blocks only, a partial block would break the frame alignment of the ring */
+    if (info->ring)
     {
-        fclose(record->fp);
-        record->fp = RT_NULL;
+        if (rt_ringbuffer_space_len(info->ring) >= size)
+            rt_ringbuffer_put(info->ring, data, size);
+        else
+            record->overrun++;
     }
 
-    if (record->device)
+#ifdef PKG_WP_USING_ASRC
+    if (record->asrc)
     {
-        rt_device_close(record->device);
-        record->device = RT_NULL;
+        wavasrc_update(record->asrc, rt_ringbuffer_data_len(info->ring) / frame, info->ring_target / frame, frames);
+        record->drift = wavasrc_ppm_get(record->asrc);
     }
+#endif
 
-    if (record->event)
+    if (info->callback)
+        info->callback(data, size, info->user_data);
+}
+
+/* write the captured block to the interleaved file or split it per channel, returns the bytes of each file */
+static rt_size_t wavrecorder_write(struct recorder *record, rt_size_t size)
+{
+    rt_size_t frames, length = 0;
+    int channels = record->info.channels;
+    int i;
+
+    frames = size / (channels * record->sample_bytes);
+
+    if (record->split_count == 0)
     {
-        rt_event_delete(record->event);
-        record->event = RT_NULL;
+        length = record->encode(record, record->buffer, frames * channels);
+        wavio_write(&record->io, record->buffer, length);
+        return length;
     }
+
+    if (record->sample_bytes == sizeof(rt_int16_t))
+        wavpcm_deinterleave16((rt_int16_t *)record->buffer, record->split_buffer, record->split_map,
+                              record->split_count, channels, frames);
+    else
+        wavpcm_deinterleave32((rt_int32_t *)record->buffer, record->split_buffer, record->split_map,
+                              record->split_count, channels, frames);
+
+    for (i = 0; i < record->split_count; i++)
+    {
+        length = record->encode(record, record->split_buffer[i], frames);
+        wavio_write(&record->split_io[i], record->split_buffer[i], length);
+    }
+
+    return length;
+}
+
+static void wavrecorder_header_write(struct recorder *record, struct wavio *io, int channels, rt_uint64_t length)
+{
+    struct wav_header wav;
+    int samplebits, format = WAVE_FORMAT_PCM;
+
+    switch (record->info.encoding)
+    {
+    case WAVRECORD_ENCODING_PACKED24:
+        samplebits = 24;
+        break;
+
+    case WAVRECORD_ENCODING_FLOAT:
+        samplebits = 32;
+        format = WAVE_FORMAT_IEEE_FLOAT;
+        break;
+
+    default:
+        samplebits = record->sample_bytes * 8;
+        break;
+    }
+
+    wavheader_init_format(&wav, record->info.samplerate, channels, samplebits,
+                          format == WAVE_FORMAT_IEEE_FLOAT ? 32 : record->info.samplebits, format, 0);
+    /* the room of a ds64 chunk is kept, so a record past 4 GB is finished as RF64 in place */
+    wavheader_ds64_reserve(&wav);
+    wavheader_datasize_set(&wav, length);
+    wavio_seek(io, 0, SEEK_SET);
+    wavheader_io_write(&wav, io);
 }
 
 static void wavrecord_entry(void *parameter)
 {
     rt_err_t result;
-    rt_size_t size;
-    struct wav_header wav = {0};
+    rt_size_t size, length;
     struct rt_audio_caps caps;
-    rt_uint32_t recv_evt, total_length = 0;
+    rt_uint32_t recv_evt;
+    rt_uint64_t total_length = 0;
+    int i;
 
     result = wavrecorder_open(&record);
     if (result != RT_EOK)
@@ -158,31 +486,52 @@ static void wavrecord_entry(void *parameter)
 
     record.activated = RT_TRUE;
 
-    /* write 44 bytes wavheader */
-    fwrite(&wav, 44, 1, record.fp);
+    /* reserve the wavheader, it is written again with the length at the end */
+    if (record.io.ops)
+        wavrecorder_header_write(&record, &record.io, record.info.channels, 0);
+    for (i = 0; i < record.split_count; i++)
+        wavrecorder_header_write(&record, &record.split_io[i], 1, 0);
 
     rt_kprintf("Information:\n");
     rt_kprintf("samplerate %d\n", record.info.samplerate);
     rt_kprintf("channels %d\n", record.info.channels);
+    rt_kprintf("sample bits width %d\n", record.info.samplebits);
 
     /* set sampletate,channels, samplebits */
     caps.main_type = AUDIO_TYPE_INPUT;
     caps.sub_type  = AUDIO_DSP_PARAM;
     caps.udata.config.samplerate = record.info.samplerate;
     caps.udata.config.channels = record.info.channels;
-    caps.udata.config.samplebits = 16;
+    caps.udata.config.samplebits = record.info.samplebits;
     rt_device_control(record.device, AUDIO_CTL_CONFIGURE, &caps);
 
-    LOG_D("ready to record, device %s, uri %s", PKG_WP_PLAY_DEVICE, record.info.uri);
+    /* levels are computed on 16 bits pcm only */
+    wavmeter_reset(&record.meter, record.info.samplebits == 16 ? record.info.channels : 0);
+
+    LOG_D("ready to record, device %s, uri %s", PKG_WP_RECORD_DEVICE, record.capture ? "memory" : record.info.uri);
 
     while (1)
     {
         /* read raw data from sound device */
-        size =  rt_device_read(record.device, 0, record.buffer, WR_BUFFER_SIZE);
+        WAVTRACE_BEGIN(WAVTRACE_EVENT_CAPTURE, 0);
+        size =  rt_device_read(record.device, 0, record.buffer, record.block_size);
+        WAVTRACE_END(WAVTRACE_EVENT_CAPTURE, size);
         if (size)
         {
-            fwrite(record.buffer, size, 1, record.fp);
-            total_length += size;
+            wavrecorder_justify(&record, size);
+            if (record.config.meter)
+                wavmeter_update(&record.meter, record.buffer, size);
+            if (record.capture)
+            {
+                wavrecorder_capture(&record, size);
+            }
+            else
+            {
+                WAVTRACE_BEGIN(WAVTRACE_EVENT_SAVE, 0);
+                length = wavrecorder_write(&record, size);
+                WAVTRACE_END(WAVTRACE_EVENT_SAVE, length);
+                total_length += length;
+            }
         }
 
         /* recive stop event */
@@ -192,12 +541,13 @@ static void wavrecord_entry(void *parameter)
         {
 
             /* re-write wav header */
-            wavheader_init(&wav, record.info.samplerate, record.info.channels, total_length);
-            fseek(record.fp, 0, SEEK_SET);
-            wavheader_write(&wav, record.fp);
+            if (record.io.ops)
+                wavrecorder_header_write(&record, &record.io, record.info.channels, total_length);
+            for (i = 0; i < record.split_count; i++)
+                wavrecorder_header_write(&record, &record.split_io[i], 1, total_length);
             wavrecorder_close(&record);
 
-            LOG_D("total_length = %d", total_length);
+            LOG_D("total_length = %u KB", (rt_uint32_t)(total_length >> 10));
 
             /* ack event */
             rt_completion_done(&record.ack);
@@ -210,11 +560,76 @@ static void wavrecord_entry(void *parameter)
     return;
 }
 
+static rt_err_t wavrecorder_format_check(int channels, int samplebits)
+{
+    if (channels == 0 || channels > PKG_WP_RECORD_CHANNELS_MAX)
+    {
+        LOG_E("unsupported channels %d", channels);
+        return -RT_EINVAL;
+    }
+
+    if (samplebits != 16 && samplebits != 24 && samplebits != 32)
+    {
+        LOG_E("unsupported sample bits %d", samplebits);
+        return -RT_EINVAL;
+    }
+
+    return RT_EOK;
+}
+
+static rt_err_t wavrecorder_thread_start(void)
+{
+    rt_thread_t tid;
+
+    record.sample_bytes = record.info.samplebits == 16 ? sizeof(rt_int16_t) : sizeof(rt_int32_t);
+    record.overrun = 0;
+
+    tid = rt_thread_create("wav_r", wavrecord_entry, RT_NULL,
+                           record.config.thread_stack_size,
+                           record.config.thread_priority, 20);
+    if (tid == RT_NULL)
+        return -RT_ENOMEM;
+
+    rt_thread_startup(tid);
+
+    return RT_EOK;
+}
+
 rt_err_t wavrecorder_start(struct wavrecord_info *info)
 {
+    rt_uint32_t frame, block_size;
+
     if (record.activated != RT_TRUE)
     {
-        rt_thread_t tid;
+        if (wavrecorder_format_check(info->channels, info->samplebits) != RT_EOK ||
+            (info->split_mask >> info->channels) != 0)
+        {
+            LOG_E("unsupported channels %d, split mask 0x%x", info->channels, info->split_mask);
+            return -RT_EINVAL;
+        }
+
+        if ((info->encoding == WAVRECORD_ENCODING_PACKED24 && info->samplebits != 24) ||
+            (info->encoding == WAVRECORD_ENCODING_FLOAT && info->samplebits == 16) ||
+            info->encoding > WAVRECORD_ENCODING_FLOAT)
+        {
+            LOG_E("unsupported sample bits %d, encoding %d", info->samplebits, info->encoding);
+            return -RT_EINVAL;
+        }
+
+        if (info->io_backend >= WAVIO_BACKEND_MAX || info->io_backend == WAVIO_BACKEND_MMAP)
+        {
+            LOG_E("io backend %s can't write files", wavio_backend_name(info->io_backend));
+            return -RT_EINVAL;
+        }
+
+        /* whole frames in each block, a partial one would shift the channels of the next */
+        frame = info->channels * (info->samplebits == 16 ? sizeof(rt_int16_t) : sizeof(rt_int32_t));
+        block_size = record.config.buffer_size - record.config.buffer_size % frame;
+        if (block_size == 0)
+        {
+            LOG_E("record block smaller than a frame");
+            return -RT_EINVAL;
+        }
 
         if (record.info.uri)
             rt_free(record.info.uri);
@@ -223,15 +638,64 @@ rt_err_t wavrecorder_start(struct wavrecord_info *info)
         record.info.samplerate = info->samplerate;
         record.info.channels   = info->channels;
         record.info.samplebits = info->samplebits;
+        record.info.split_mask = info->split_mask;
+        record.info.encoding   = info->encoding;
+        record.info.io_backend = info->io_backend;
+        record.capture         = RT_FALSE;
+        record.block_size      = block_size;
 
-        tid = rt_thread_create("wav_r", wavrecord_entry, RT_NULL, 2048, 19, 20);
-        if (tid)
-            rt_thread_startup(tid);
+        wavrecorder_thread_start();
     }
 
     return RT_EOK;
 }
 
+rt_err_t wavrecorder_capture_start(const struct wavcapture_info *info)
+{
+    rt_uint32_t frame;
+
+    if (info == RT_NULL)
+        return -RT_EINVAL;
+
+    if (record.activated == RT_TRUE)
+        return -RT_EBUSY;
+
+    if (wavrecorder_format_check(info->channels, info->samplebits) != RT_EOK)
+        return -RT_EINVAL;
+
+    /* whole frames in each block */
+    frame = info->channels * (info->samplebits == 16 ? sizeof(rt_int16_t) : sizeof(rt_int32_t));
+    record.block_size = info->block_size ? info->block_size : record.config.buffer_size;
+    record.block_size -= record.block_size % frame;
+    if (record.block_size == 0)
+    {
+        LOG_E("capture block smaller than a frame");
+        return -RT_EINVAL;
+    }
+
+    record.info.samplerate = info->samplerate;
+    record.info.channels   = info->channels;
+    record.info.samplebits = info->samplebits;
+    record.info.split_mask = 0;
+    record.info.encoding   = WAVRECORD_ENCODING_PCM;
+    record.capture         = RT_TRUE;
+    record.capture_info    = *info;
+
+    return wavrecorder_thread_start();
+}
+
+rt_uint32_t wavrecorder_capture_overrun_get(void)
+{
+    return record.overrun;
+}
+
+#ifdef PKG_WP_USING_ASRC
+rt_int32_t wavrecorder_capture_drift_get(void)
+{
+    return record.drift;
+}
+#endif
+
 rt_err_t wavrecorder_stop(void)
 {
     if (record.activated == RT_TRUE)
@@ -248,3 +712,37 @@ rt_bool_t wavrecorder_is_actived(void)
 {
     return record.activated;
 }
+
+rt_err_t wavrecorder_config_get(struct wavrecorder_config *config)
+{
+    if (config == RT_NULL)
+        return -RT_EINVAL;
+
+    *config = record.config;
+
+    return RT_EOK;
+}
+
+rt_err_t wavrecorder_config_set(const struct wavrecorder_config *config)
+{
+    if (config == RT_NULL || config->buffer_size == 0 ||
+        config->thread_priority >= RT_THREAD_PRIORITY_MAX)
+        return -RT_EINVAL;
+
+    if (record.activated == RT_TRUE)
+        return -RT_EBUSY;
+
+    record.config = *config;
+
+    return RT_EOK;
+}
+
+rt_err_t wavrecorder_meter_get(struct wavmeter_level *level)
+{
+    if (level == RT_NULL)
+        return -RT_EINVAL;
+
+    wavmeter_read(&record.meter, level);
+
+    return RT_EOK;
+}
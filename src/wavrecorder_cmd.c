@@ -11,8 +11,10 @@
 #include <rtdevice.h>
 #include <optparse.h>
 #include <wavrecorder.h>
+#include <wavio.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 enum WAVRECORDER_ACTTION
 {
@@ -28,6 +30,9 @@ struct wavrecord_args
     rt_uint32_t samplerate;
     rt_uint16_t channels;
     rt_uint16_t samplebits;
+    rt_uint32_t split_mask;
+    rt_uint8_t encoding;
+    rt_uint8_t io_backend;
 };
 
 static struct optparse_long opts[] =
@@ -35,6 +40,9 @@ static struct optparse_long opts[] =
     {"help", 'h', OPTPARSE_NONE    },       /* 帮助 */
     {"start", 's', OPTPARSE_REQUIRED},      /* 开始录音 */
     {"stop", 't', OPTPARSE_NONE    },       /* 停止录音 */
+    {"split", 'm', OPTPARSE_REQUIRED},      /* 按声道分文件 */
+    {"encoding", 'e', OPTPARSE_REQUIRED},   /* 文件采样格式 */
+    {"io", 'i', OPTPARSE_REQUIRED},         /* 文件读写方式 */
     { NULL,  0,  OPTPARSE_NONE    }
 };
 
@@ -45,12 +53,18 @@ static void usage(void)
     rt_kprintf("  -h,     --help                        Print defined help message.\n");
     rt_kprintf("  -s file --start=file  <samplerate> <channels> <samplebits> \n");
     rt_kprintf("                                        record wav music to filesystem.\n");
+    rt_kprintf("  -m mask --split=mask                  Write each channel in mask to its own file,\n");
+    rt_kprintf("                                        place it after <samplebits>.\n");
+    rt_kprintf("  -e enc  --encoding=enc                Store samples as pcm, packed24 or float,\n");
+    rt_kprintf("                                        place it after <samplebits>.\n");
+    rt_kprintf("  -i io   --io=io                       Write files with stdio, fd or direct,\n");
+    rt_kprintf("                                        place it after <samplebits>.\n");
     rt_kprintf("  -t,     --stop                        Stop record.\n");
 }
 
 int wavrecord_args_prase(int argc, char *argv[], struct wavrecord_args *record_args)
 {
-    int ch;
+    int ch, backend;
     int option_index;
     struct optparse options;
     rt_err_t result = RT_EOK;
@@ -83,6 +97,29 @@ int wavrecord_args_prase(int argc, char *argv[], struct wavrecord_args *record_a
             record_args->action = WAVRECORDER_ACTION_STOP;
             break;
 
+        case 'm':
+            record_args->split_mask = strtoul(options.optarg, RT_NULL, 0);
+            break;
+
+        case 'e':
+            if (strcmp(options.optarg, "pcm") == 0)
+                record_args->encoding = WAVRECORD_ENCODING_PCM;
+            else if (strcmp(options.optarg, "packed24") == 0)
+                record_args->encoding = WAVRECORD_ENCODING_PACKED24;
+            else if (strcmp(options.optarg, "float") == 0)
+                record_args->encoding = WAVRECORD_ENCODING_FLOAT;
+            else
+                result = -RT_EINVAL;
+            break;
+
+        case 'i':
+            backend = wavio_backend_find(options.optarg);
+            if (backend < 0)
+                result = -RT_EINVAL;
+            else
+                record_args->io_backend = backend;
+            break;
+
         default:
             result = -RT_EINVAL;
             break;
@@ -98,6 +135,7 @@ int wav_recorder(int argc, char *argv[])
     struct wavrecord_args record_args = {0};
     struct wavrecord_info info = {0};
 
+    record_args.io_backend = PKG_WP_IO_BACKEND;
     result = wavrecord_args_prase(argc, argv, &record_args);
     if (result != RT_EOK)
     {
@@ -116,6 +154,9 @@ int wav_recorder(int argc, char *argv[])
         info.samplerate = record_args.samplerate;
         info.channels = record_args.channels;
         info.samplebits = record_args.samplebits;
+        info.split_mask = record_args.split_mask;
+        info.encoding = record_args.encoding;
+        info.io_backend = record_args.io_backend;
         wavrecorder_start(&info);
         break;
 
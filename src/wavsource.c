@@ -0,0 +1,693 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavhdr.h>
+#include <wavsource.h>
+#ifdef PKG_WP_USING_ASRC
+#include <wavasrc.h>
+#endif
+
+#define DBG_TAG              "WAV_SOURCE"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+enum PUSH_EVENT
+{
+    PUSH_EVENT_DATA  = 0x01,
+    PUSH_EVENT_SPACE = 0x02,
+};
+
+struct wavsource_file
+{
+    struct wavsource parent;
+    char *uri;
+    int backend;                            /* WAVIO_BACKEND_xxx */
+    struct wavio io;
+    rt_off_t data_offset;
+    rt_ssize_t data_size;                   /* < 0 when the header doesn't know it */
+};
+
+struct wavsource_mem
+{
+    struct wavsource parent;
+    struct wavsource_format format;
+    const rt_uint8_t *pcm;
+    rt_size_t size;
+    rt_size_t pos;
+};
+
+struct wavsource_push
+{
+    struct wavsource parent;
+    struct wavsource_format format;
+    rt_uint8_t *buffer;
+    rt_size_t capacity;
+    rt_size_t target;
+    /* byte indexes running over twice the capacity, so a full ring differs from an empty one */
+    volatile rt_size_t write_index;         /* pushed by the producer */
+    volatile rt_size_t read_index;          /* released by the player */
+    rt_size_t reserve_index;                /* handed to the player, not played yet */
+    rt_event_t event;
+    rt_bool_t buffering;
+    volatile rt_bool_t finished;
+    volatile rt_bool_t closed;
+    rt_bool_t opened;                       /* played by a player, its settings are fixed */
+    rt_uint32_t underflow;
+#ifdef PKG_WP_USING_ASRC
+    struct wavasrc *asrc;                   /* drift compensation, the ring is copied out instead */
+#endif
+};
+
+/* file source */
+
+static rt_err_t file_open(struct wavsource *source, struct wavsource_format *format)
+{
+    struct wavsource_file *file = (struct wavsource_file *)source;
+    struct wav_header wav;
+
+    if (wavio_open(&file->io, file->uri, WAVIO_MODE_READ, file->backend) != RT_EOK)
+    {
+        LOG_E("open file %s failed", file->uri);
+        return -RT_ERROR;
+    }
+
+    /* read wavfile header information from file */
+    if (wavheader_io_read(&wav, &file->io) != 0)
+    {
+        LOG_E("%s isn't a wav file", file->uri);
+        wavio_close(&file->io);
+        return -RT_ERROR;
+    }
+    file->data_offset = wavio_tell(&file->io);
+    /* sizes past what a read can return are left to the end of file */
+    file->data_size = wav.datasize > 0 && wav.datasize <= ((rt_size_t)-1 >> 1) ? (rt_ssize_t)wav.datasize : -1;
+
+    format->samplerate = wav.fmt_sample_rate;
+    format->channels = wav.fmt_channels;
+    format->samplebits = wav.fmt_bit_per_sample;
+    format->encoding = wav.fmt_sub_format == WAVE_FORMAT_IEEE_FLOAT ? WAVSOURCE_ENCODING_FLOAT : WAVSOURCE_ENCODING_PCM;
+
+    return RT_EOK;
+}
+
+static rt_ssize_t file_read(struct wavsource *source, void *buffer, rt_size_t size, void **data)
+{
+    struct wavsource_file *file = (struct wavsource_file *)source;
+
+    /* mapped files are played from the mapping */
+    return wavio_read_ref(&file->io, buffer, size, data);
+}
+
+static rt_err_t file_seek(struct wavsource *source, rt_off_t offset)
+{
+    struct wavsource_file *file = (struct wavsource_file *)source;
+
+    return wavio_seek(&file->io, file->data_offset + offset, SEEK_SET) >= 0 ? RT_EOK : -RT_ERROR;
+}
+
+static rt_ssize_t file_length(struct wavsource *source)
+{
+    struct wavsource_file *file = (struct wavsource_file *)source;
+
+    return file->data_size;
+}
+
+static void file_close(struct wavsource *source)
+{
+    struct wavsource_file *file = (struct wavsource_file *)source;
+
+    wavio_close(&file->io);
+}
+
+static void file_destroy(struct wavsource *source)
+{
+    struct wavsource_file *file = (struct wavsource_file *)source;
+
+    file_close(source);
+    rt_free(file->uri);
+    rt_free(file);
+}
+
+static const struct wavsource_ops file_ops =
+{
+    file_open,
+    file_read,
+    RT_NULL,
+    file_seek,
+    file_close,
+    file_destroy,
+    file_length,
+};
+
+struct wavsource *wavsource_file_create(const char *uri)
+{
+    return wavsource_file_create_io(uri, PKG_WP_IO_BACKEND);
+}
+
+struct wavsource *wavsource_file_create_io(const char *uri, int backend)
+{
+    struct wavsource_file *file;
+
+    file = rt_malloc(sizeof(struct wavsource_file));
+    if (file == RT_NULL)
+        return RT_NULL;
+    rt_memset(file, 0, sizeof(struct wavsource_file));
+
+    file->uri = rt_strdup(uri);
+    if (file->uri == RT_NULL)
+    {
+        rt_free(file);
+        return RT_NULL;
+    }
+
+    file->parent.ops = &file_ops;
+    file->parent.name = file->uri;
+    file->backend = backend;
+
+    return &file->parent;
+}
+
+/* memory source */
+
+static rt_uint32_t mem_get_le(const rt_uint8_t *p, int bytes)
+{
+    rt_uint32_t value = 0;
+
+    while (bytes--)
+        value = (value << 8) | p[bytes];
+
+    return value;
+}
+
+/* walk the riff chunks of a wav image for "fmt " and "data" */
+static rt_err_t mem_parse(struct wavsource_mem *mem, const rt_uint8_t *image, rt_size_t size)
+{
+    rt_size_t offset = 12, chunk;
+    rt_uint32_t code;
+    rt_bool_t fmt = RT_FALSE;
+
+    if (size < 12 || rt_memcmp(image, "RIFF", 4) != 0 || rt_memcmp(image + 8, "WAVE", 4) != 0)
+        return -RT_ERROR;
+
+    while (offset + 8 <= size)
+    {
+        chunk = mem_get_le(image + offset + 4, 4);
+        if (rt_memcmp(image + offset, "data", 4) == 0 && fmt)
+        {
+            /* a truncated image plays what it holds */
+            mem->pcm = image + offset + 8;
+            mem->size = size - offset - 8;
+            if (chunk < mem->size)
+                mem->size = chunk;
+            return RT_EOK;
+        }
+
+        /* a chunk past the end of the image is corrupt */
+        if (chunk > size - offset - 8)
+            break;
+
+        if (rt_memcmp(image + offset, "fmt ", 4) == 0 && chunk >= 16)
+        {
+            mem->format.channels = mem_get_le(image + offset + 10, 2);
+            mem->format.samplerate = mem_get_le(image + offset + 12, 4);
+            mem->format.samplebits = mem_get_le(image + offset + 22, 2);
+            if (mem->format.channels == 0 || mem->format.samplebits == 0)
+                return -RT_ERROR;
+            code = mem_get_le(image + offset + 8, 2);
+            if (code == WAVE_FORMAT_EXTENSIBLE && chunk >= 40)
+                code = mem_get_le(image + offset + 32, 2);
+            mem->format.encoding = code == WAVE_FORMAT_IEEE_FLOAT ? WAVSOURCE_ENCODING_FLOAT : WAVSOURCE_ENCODING_PCM;
+            fmt = RT_TRUE;
+        }
+        offset += 8 + chunk + (chunk & 1);
+    }
+
+    return -RT_ERROR;
+}
+
+static rt_err_t mem_open(struct wavsource *source, struct wavsource_format *format)
+{
+    struct wavsource_mem *mem = (struct wavsource_mem *)source;
+
+    mem->pos = 0;
+    *format = mem->format;
+
+    return RT_EOK;
+}
+
+static rt_ssize_t mem_read(struct wavsource *source, void *buffer, rt_size_t size, void **data)
+{
+    struct wavsource_mem *mem = (struct wavsource_mem *)source;
+
+    if (size > mem->size - mem->pos)
+        size = mem->size - mem->pos;
+
+    /* played straight from memory */
+    *data = (void *)(mem->pcm + mem->pos);
+    mem->pos += size;
+
+    return size;
+}
+
+static rt_err_t mem_seek(struct wavsource *source, rt_off_t offset)
+{
+    struct wavsource_mem *mem = (struct wavsource_mem *)source;
+
+    if (offset < 0 || (rt_size_t)offset > mem->size)
+        return -RT_EINVAL;
+
+    mem->pos = offset;
+
+    return RT_EOK;
+}
+
+static rt_ssize_t mem_length(struct wavsource *source)
+{
+    struct wavsource_mem *mem = (struct wavsource_mem *)source;
+
+    return mem->size;
+}
+
+static void mem_close(struct wavsource *source)
+{
+}
+
+static void mem_destroy(struct wavsource *source)
+{
+    rt_free(source);
+}
+
+static const struct wavsource_ops mem_ops =
+{
+    mem_open,
+    mem_read,
+    RT_NULL,
+    mem_seek,
+    mem_close,
+    mem_destroy,
+    mem_length,
+};
+
+struct wavsource *wavsource_mem_create(const void *data, rt_size_t size, const struct wavsource_format *format)
+{
+    struct wavsource_mem *mem;
+
+    if (data == RT_NULL)
+        return RT_NULL;
+
+    mem = rt_malloc(sizeof(struct wavsource_mem));
+    if (mem == RT_NULL)
+        return RT_NULL;
+    rt_memset(mem, 0, sizeof(struct wavsource_mem));
+
+    if (format)
+    {
+        mem->format = *format;
+        mem->pcm = data;
+        mem->size = size;
+    }
+    else if (mem_parse(mem, data, size) != RT_EOK)
+    {
+        LOG_E("invalid wav image in memory");
+        rt_free(mem);
+        return RT_NULL;
+    }
+
+    mem->parent.ops = &mem_ops;
+    mem->parent.name = "memory";
+
+    return &mem->parent;
+}
+
+/* push source */
+
+/* orders the ring data against the indexes on multi core targets */
+#if defined(RT_USING_SMP) && defined(__GNUC__)
+#define PUSH_BARRIER() __sync_synchronize()
+#else
+#define PUSH_BARRIER()
+#endif
+
+/* bytes from one index to another */
+static rt_size_t push_distance(struct wavsource_push *push, rt_size_t from, rt_size_t to)
+{
+    return to >= from ? to - from : to + 2 * push->capacity - from;
+}
+
+static rt_size_t push_advance(struct wavsource_push *push, rt_size_t index, rt_size_t size)
+{
+    index += size;
+
+    return index >= 2 * push->capacity ? index - 2 * push->capacity : index;
+}
+
+static rt_size_t push_offset(struct wavsource_push *push, rt_size_t index)
+{
+    return index >= push->capacity ? index - push->capacity : index;
+}
+
+static rt_err_t push_open(struct wavsource *source, struct wavsource_format *format)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    push->buffering = RT_TRUE;
+    push->closed = RT_FALSE;
+    push->opened = RT_TRUE;
+    *format = push->format;
+#ifdef PKG_WP_USING_ASRC
+    if (push->asrc)
+        wavasrc_init(push->asrc, push->format.samplerate, push->format.channels);
+#endif
+
+    return RT_EOK;
+}
+
+static rt_int32_t push_block_tick(struct wavsource_push *push, rt_size_t size)
+{
+    rt_uint32_t bytes_per_sec;
+
+    bytes_per_sec = push->format.samplerate * push->format.channels * push->format.samplebits / 8;
+    if (bytes_per_sec == 0)
+        return 1;
+
+    return rt_tick_from_millisecond((rt_int32_t)((rt_uint64_t)size * 1000 / bytes_per_sec)) + 1;
+}
+
+static rt_ssize_t push_silence(void *buffer, rt_size_t size, void **data)
+{
+    rt_memset(buffer, 0, size);
+    *data = buffer;
+
+    return size;
+}
+
+#ifdef PKG_WP_USING_ASRC
+/* resample out of the ring at the ratio following the producer clock */
+static rt_ssize_t push_resample(struct wavsource_push *push, void *buffer, rt_size_t size, void **data)
+{
+    rt_size_t frame = push->format.channels * sizeof(rt_int16_t);
+    rt_size_t out_frames = size / frame, produced = 0;
+    rt_size_t level, offset, frames, used;
+
+    while (produced < out_frames)
+    {
+        level = push_distance(push, push->reserve_index, push->write_index) / frame;
+        if (level == 0)
+            break;
+
+        offset = push_offset(push, push->reserve_index);
+        frames = (push->capacity - offset) / frame;
+        if (frames > level)
+            frames = level;
+
+        produced += wavasrc_process(push->asrc, (const rt_int16_t *)(push->buffer + offset), frames,
+                                    (rt_int16_t *)buffer + produced * push->format.channels,
+                                    out_frames - produced, &used);
+        push->reserve_index = push_advance(push, push->reserve_index, used * frame);
+    }
+
+    /* nothing handed out stays in the ring, its space is free at once */
+    PUSH_BARRIER();
+    push->read_index = push->reserve_index;
+    rt_event_send(push->event, PUSH_EVENT_SPACE);
+
+    if (produced == 0)
+        return push_silence(buffer, size, data);
+
+    wavasrc_update(push->asrc, push_distance(push, push->reserve_index, push->write_index) / frame,
+                   push->target / frame, produced);
+    *data = buffer;
+
+    return produced * frame;
+}
+#endif
+
+static rt_ssize_t push_read(struct wavsource *source, void *buffer, rt_size_t size, void **data)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+    rt_size_t level, offset;
+    rt_uint32_t recv_evt;
+
+    level = push_distance(push, push->reserve_index, push->write_index);
+
+    /* refill the jitter buffer up to its target depth, wait at most one block for it */
+    if (push->buffering && level < push->target && !push->finished)
+    {
+        rt_event_recv(push->event, PUSH_EVENT_DATA, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                      push_block_tick(push, size), &recv_evt);
+        level = push_distance(push, push->reserve_index, push->write_index);
+        if (level < push->target && !push->finished)
+            return push_silence(buffer, size, data);
+    }
+    push->buffering = RT_FALSE;
+
+    if (level == 0)
+    {
+        if (push->finished)
+            return 0;
+
+        /* counted only, a log would add to the delay of the reader */
+        push->underflow++;
+        push->buffering = RT_TRUE;
+        return push_silence(buffer, size, data);
+    }
+
+#ifdef PKG_WP_USING_ASRC
+    if (push->asrc)
+        return push_resample(push, buffer, size, data);
+#endif
+
+    /* hand out the contiguous part of the ring without copying */
+    offset = push_offset(push, push->reserve_index);
+    if (size > level)
+        size = level;
+    if (size > push->capacity - offset)
+        size = push->capacity - offset;
+
+    *data = push->buffer + offset;
+    push->reserve_index = push_advance(push, push->reserve_index, size);
+
+    return size;
+}
+
+static void push_release(struct wavsource *source, void *data, rt_size_t size)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    /* silence blocks don't live in the ring */
+    if ((rt_uint8_t *)data < push->buffer || (rt_uint8_t *)data >= push->buffer + push->capacity)
+        return;
+
+    PUSH_BARRIER();
+    push->read_index = push_advance(push, push->read_index, size);
+    rt_event_send(push->event, PUSH_EVENT_SPACE);
+}
+
+static void push_close(struct wavsource *source)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    /* data handed out but not played is dropped */
+    push->read_index = push->reserve_index;
+    push->closed = RT_TRUE;
+    push->opened = RT_FALSE;
+    rt_event_send(push->event, PUSH_EVENT_SPACE);
+}
+
+static void push_destroy(struct wavsource *source)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    rt_event_delete(push->event);
+#ifdef PKG_WP_USING_ASRC
+    if (push->asrc)
+        rt_free(push->asrc);
+#endif
+    rt_free(push->buffer);
+    rt_free(push);
+}
+
+static const struct wavsource_ops push_ops =
+{
+    push_open,
+    push_read,
+    push_release,
+    RT_NULL,
+    push_close,
+    push_destroy,
+    RT_NULL,
+};
+
+struct wavsource *wavsource_push_create(const struct wavsource_format *format, rt_size_t capacity, rt_size_t target)
+{
+    struct wavsource_push *push;
+    rt_size_t frame;
+
+    if (format == RT_NULL || capacity == 0 || target > capacity || capacity > ((rt_size_t)-1 >> 1))
+        return RT_NULL;
+
+    /* blocks are handed out of the ring as is, a frame must not be split at its end */
+    frame = format->channels * format->samplebits / 8;
+    if (frame == 0 || capacity % frame != 0)
+    {
+        LOG_E("push capacity %u isn't a multiple of %u bytes frames", (rt_uint32_t)capacity, (rt_uint32_t)frame);
+        return RT_NULL;
+    }
+
+    push = rt_malloc(sizeof(struct wavsource_push));
+    if (push == RT_NULL)
+        return RT_NULL;
+    rt_memset(push, 0, sizeof(struct wavsource_push));
+
+    push->buffer = rt_malloc(capacity);
+    push->event = rt_event_create("wp_push", RT_IPC_FLAG_FIFO);
+    if (push->buffer == RT_NULL || push->event == RT_NULL)
+    {
+        if (push->buffer)
+            rt_free(push->buffer);
+        if (push->event)
+            rt_event_delete(push->event);
+        rt_free(push);
+        return RT_NULL;
+    }
+
+    push->format = *format;
+    push->capacity = capacity;
+    push->target = target;
+    push->buffering = RT_TRUE;
+    push->parent.ops = &push_ops;
+    push->parent.name = "push";
+
+    return &push->parent;
+}
+
+rt_ssize_t wavsource_push_write(struct wavsource *source, const void *data, rt_size_t size, rt_int32_t timeout)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+    const rt_uint8_t *ptr = data;
+    rt_size_t space, offset, length, pushed = 0;
+    rt_uint32_t recv_evt;
+
+    RT_ASSERT(source != RT_NULL && source->ops == &push_ops);
+
+    while (size > 0)
+    {
+        if (push->closed)
+            return pushed ? (rt_ssize_t)pushed : -RT_ERROR;
+
+        space = push->capacity - push_distance(push, push->read_index, push->write_index);
+        if (space == 0)
+        {
+            if (rt_event_recv(push->event, PUSH_EVENT_SPACE, RT_EVENT_FLAG_OR | RT_EVENT_FLAG_CLEAR,
+                              timeout, &recv_evt) != RT_EOK)
+                break;
+            continue;
+        }
+
+        /* copy up to the end of the ring, the rest on the next turn */
+        offset = push_offset(push, push->write_index);
+        length = size < space ? size : space;
+        if (length > push->capacity - offset)
+            length = push->capacity - offset;
+
+        rt_memcpy(push->buffer + offset, ptr, length);
+        /* the data is visible before the index that publishes it */
+        PUSH_BARRIER();
+        push->write_index = push_advance(push, push->write_index, length);
+        rt_event_send(push->event, PUSH_EVENT_DATA);
+
+        ptr += length;
+        size -= length;
+        pushed += length;
+    }
+
+    return pushed;
+}
+
+void wavsource_push_finish(struct wavsource *source)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    RT_ASSERT(source != RT_NULL && source->ops == &push_ops);
+
+    push->finished = RT_TRUE;
+    rt_event_send(push->event, PUSH_EVENT_DATA);
+}
+
+rt_size_t wavsource_push_level(struct wavsource *source)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    RT_ASSERT(source != RT_NULL && source->ops == &push_ops);
+
+    return push_distance(push, push->reserve_index, push->write_index);
+}
+
+#ifdef PKG_WP_USING_ASRC
+rt_err_t wavsource_push_drift_enable(struct wavsource *source, rt_bool_t enable)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    RT_ASSERT(source != RT_NULL && source->ops == &push_ops);
+
+    /* the player thread resamples with it while the source is open */
+    if (push->opened)
+        return -RT_EBUSY;
+
+    if (!enable)
+    {
+        if (push->asrc)
+        {
+            rt_free(push->asrc);
+            push->asrc = RT_NULL;
+        }
+        return RT_EOK;
+    }
+
+    /* the ring holds whole frames, the resampler doesn't see the wrap */
+    if (push->format.samplebits != 16 || push->format.channels > PKG_WP_ASRC_CHANNELS_MAX)
+        return -RT_EINVAL;
+
+    if (push->asrc == RT_NULL)
+    {
+        push->asrc = rt_malloc(sizeof(struct wavasrc));
+        if (push->asrc == RT_NULL)
+            return -RT_ENOMEM;
+    }
+
+    return wavasrc_init(push->asrc, push->format.samplerate, push->format.channels);
+}
+
+rt_int32_t wavsource_push_drift_get(struct wavsource *source)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    RT_ASSERT(source != RT_NULL && source->ops == &push_ops);
+
+    return push->asrc ? wavasrc_ppm_get(push->asrc) : 0;
+}
+#endif
+
+rt_uint32_t wavsource_push_underflow(struct wavsource *source)
+{
+    struct wavsource_push *push = (struct wavsource_push *)source;
+
+    RT_ASSERT(source != RT_NULL && source->ops == &push_ops);
+
+    return push->underflow;
+}
+
+void wavsource_delete(struct wavsource *source)
+{
+    if (source == RT_NULL)
+        return;
+
+    source->ops->destroy(source);
+}
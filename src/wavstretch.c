@@ -0,0 +1,514 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavsource.h>
+
+#define DBG_TAG              "WAV_STRETCH"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+/* segment geometry, tuned for speech */
+#define STRETCH_SEQUENCE_MS  (30)           /* length of each segment */
+#define STRETCH_OVERLAP_MS   (8)            /* crossfade between segments */
+#define STRETCH_SEEK_MS      (12)           /* search range of the best overlap */
+#define STRETCH_COARSE_STEP  (4)            /* frames between the positions of the first search pass */
+
+#define STRETCH_SPEED_MIN    (0x8000)       /* 0.5 in Q16 */
+#define STRETCH_SPEED_MAX    (0x20000)      /* 2.0 in Q16 */
+
+/*
+ * Waveform similarity overlap-add. Each segment of the output starts with a
+ * crossfade from the tail of the previous segment to the input position that
+ * matches it best within the seek range, the nominal input position advances
+ * by (sequence - overlap) * speed per segment of (sequence - overlap) frames.
+ */
+struct wavsource_stretch
+{
+    struct wavsource parent;
+    struct wavsource *source;
+    volatile rt_uint32_t speed;             /* Q16 */
+
+    struct wavsource_format format;
+    rt_bool_t bypass;                       /* format isn't stretched, reads go to the source */
+    int channels;
+    rt_size_t frame_bytes;
+    rt_size_t sequence;                     /* frames */
+    rt_size_t overlap;
+    rt_size_t seek;
+
+    /* look-ahead of seek + sequence frames plus the largest advance */
+    rt_int16_t *in;
+    rt_size_t in_bytes;
+    rt_size_t in_capacity;                  /* bytes */
+    rt_bool_t eof;
+    rt_size_t tail;                         /* frames of the source left in the look-ahead after eof */
+    rt_bool_t finished;
+    rt_uint32_t skip_frac;                  /* Q16 fraction of the input advance */
+    rt_off_t read_pos;                      /* bytes read from the source */
+    rt_off_t pos;                           /* bytes returned by read */
+
+    rt_int16_t *mid;                        /* tail of the last segment, crossfaded into the next one */
+    rt_bool_t mid_valid;
+    rt_int16_t *out;                        /* output of the last segment */
+    rt_size_t out_pos;                      /* bytes */
+    rt_size_t out_bytes;
+
+    /* downmix of the tail and the search range, compared as mono */
+    rt_int16_t *mix_mid;
+    rt_int16_t *mix_in;
+};
+
+static rt_uint32_t stretch_sqrt(rt_uint64_t value)
+{
+    rt_uint64_t root = 0, bit = 1ULL << 62;
+
+    while (bit > value)
+        bit >>= 2;
+
+    while (bit)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (rt_uint32_t)root;
+}
+
+static rt_uint32_t stretch_speed(float speed)
+{
+    rt_uint32_t value;
+
+    if (!(speed >= 0.5f && speed <= 2.0f))
+        return 0;
+
+    value = (rt_uint32_t)(speed * 65536.0f + 0.5f);
+    if (value < STRETCH_SPEED_MIN)
+        value = STRETCH_SPEED_MIN;
+    if (value > STRETCH_SPEED_MAX)
+        value = STRETCH_SPEED_MAX;
+
+    return value;
+}
+
+static void stretch_downmix(const rt_int16_t *in, rt_int16_t *out, rt_size_t frames, int channels)
+{
+    rt_size_t n;
+    rt_int32_t sum;
+    int c;
+
+    if (channels == 1)
+    {
+        rt_memcpy(out, in, frames * sizeof(rt_int16_t));
+        return;
+    }
+
+    for (n = 0; n < frames; n++)
+    {
+        sum = 0;
+        for (c = 0; c < channels; c++)
+            sum += in[c];
+        out[n] = (rt_int16_t)(sum / channels);
+        in += channels;
+    }
+}
+
+/* normalized cross correlation on every other frame, integer only */
+static rt_int64_t stretch_score(const rt_int16_t *mid, const rt_int16_t *in, rt_size_t overlap)
+{
+    rt_int64_t corr = 0;
+    rt_uint64_t norm = 0;
+    rt_size_t i;
+
+    for (i = 0; i < overlap; i += 2)
+    {
+        corr += (rt_int32_t)mid[i] * in[i];
+        norm += (rt_uint32_t)((rt_int32_t)in[i] * in[i]);
+    }
+
+    return corr / ((rt_int64_t)stretch_sqrt(norm) + 1);
+}
+
+/* best start of the next segment in 0 ~ seek, a coarse pass then a refinement around its best */
+static rt_size_t stretch_search(struct wavsource_stretch *st)
+{
+    rt_size_t pos, best = 0, low, high;
+    rt_int64_t score, best_score;
+
+    stretch_downmix(st->in, st->mix_in, st->seek + st->overlap, st->channels);
+
+    best_score = stretch_score(st->mix_mid, st->mix_in, st->overlap);
+    for (pos = STRETCH_COARSE_STEP; pos <= st->seek; pos += STRETCH_COARSE_STEP)
+    {
+        score = stretch_score(st->mix_mid, st->mix_in + pos, st->overlap);
+        if (score > best_score)
+        {
+            best_score = score;
+            best = pos;
+        }
+    }
+
+    low = best > STRETCH_COARSE_STEP ? best - STRETCH_COARSE_STEP + 1 : 0;
+    high = best + STRETCH_COARSE_STEP - 1 < st->seek ? best + STRETCH_COARSE_STEP - 1 : st->seek;
+    for (pos = low; pos <= high; pos++)
+    {
+        score = stretch_score(st->mix_mid, st->mix_in + pos, st->overlap);
+        if (score > best_score)
+        {
+            best_score = score;
+            best = pos;
+        }
+    }
+
+    return best;
+}
+
+/* top the look-ahead up from the source, returns RT_FALSE when a segment can't be made yet */
+static rt_bool_t stretch_fill(struct wavsource_stretch *st)
+{
+    rt_size_t need = (st->seek + st->sequence) * st->frame_bytes;
+    rt_ssize_t length;
+    void *data;
+
+    while (!st->eof && st->in_bytes < st->in_capacity)
+    {
+        length = st->source->ops->read(st->source, (rt_uint8_t *)st->in + st->in_bytes,
+                                       st->in_capacity - st->in_bytes, &data);
+        if (length <= 0)
+        {
+            st->eof = RT_TRUE;
+            st->tail = st->in_bytes / st->frame_bytes;
+            break;
+        }
+
+        if (data != (rt_uint8_t *)st->in + st->in_bytes)
+            rt_memcpy((rt_uint8_t *)st->in + st->in_bytes, data, length);
+        if (st->source->ops->release)
+            st->source->ops->release(st->source, data, length);
+        st->in_bytes += length;
+        st->read_pos += length;
+    }
+
+    if (st->in_bytes >= st->in_capacity)
+        return RT_TRUE;
+    if (!st->eof || st->tail == 0)
+        return RT_FALSE;
+
+    /* the last segments read silence past the end of the source */
+    if (st->in_bytes < need)
+    {
+        rt_memset((rt_uint8_t *)st->in + st->in_bytes, 0, need - st->in_bytes);
+        st->in_bytes = need;
+    }
+
+    return RT_TRUE;
+}
+
+static void stretch_segment(struct wavsource_stretch *st)
+{
+    int channels = st->channels;
+    rt_size_t overlap = st->overlap * channels;
+    rt_size_t copy = (st->sequence - 2 * st->overlap) * channels;
+    rt_size_t offset = 0, skip, i;
+    const rt_int16_t *src;
+    rt_int32_t weight;
+    rt_uint32_t advance;
+
+    if (st->mid_valid)
+        offset = stretch_search(st);
+    src = st->in + offset * channels;
+
+    /* crossfade, both weights add up to the overlap length */
+    if (st->mid_valid)
+    {
+        for (i = 0; i < overlap; i++)
+        {
+            weight = i / channels;
+            st->out[i] = (rt_int16_t)(((rt_int32_t)st->mid[i] * ((rt_int32_t)st->overlap - weight) +
+                                       (rt_int32_t)src[i] * weight) / (rt_int32_t)st->overlap);
+        }
+    }
+    else
+    {
+        rt_memcpy(st->out, src, overlap * sizeof(rt_int16_t));
+    }
+    rt_memcpy(st->out + overlap, src + overlap, copy * sizeof(rt_int16_t));
+    rt_memcpy(st->mid, src + overlap + copy, overlap * sizeof(rt_int16_t));
+    stretch_downmix(st->mid, st->mix_mid, st->overlap, channels);
+    st->mid_valid = RT_TRUE;
+
+    st->out_pos = 0;
+    st->out_bytes = (overlap + copy) * sizeof(rt_int16_t);
+
+    /* speed is taken per segment, changes apply without restarting the stream */
+    advance = (st->sequence - st->overlap) * st->speed + st->skip_frac;
+    skip = advance >> 16;
+    st->skip_frac = advance & 0xFFFF;
+
+    if (st->eof)
+    {
+        if (skip >= st->tail)
+            st->finished = RT_TRUE;
+        else
+            st->tail -= skip;
+    }
+
+    skip *= st->frame_bytes;
+    if (skip > st->in_bytes)
+        skip = st->in_bytes;
+    st->in_bytes -= skip;
+    rt_memmove(st->in, (rt_uint8_t *)st->in + skip, st->in_bytes);
+}
+
+static void stretch_free(struct wavsource_stretch *st)
+{
+    if (st->in)
+    {
+        rt_free(st->in);
+        st->in = RT_NULL;
+    }
+    if (st->mid)
+    {
+        rt_free(st->mid);
+        st->mid = RT_NULL;
+    }
+    if (st->out)
+    {
+        rt_free(st->out);
+        st->out = RT_NULL;
+    }
+    if (st->mix_mid)
+    {
+        rt_free(st->mix_mid);
+        st->mix_mid = RT_NULL;
+    }
+    if (st->mix_in)
+    {
+        rt_free(st->mix_in);
+        st->mix_in = RT_NULL;
+    }
+}
+
+static void stretch_restart(struct wavsource_stretch *st)
+{
+    st->in_bytes = 0;
+    st->eof = RT_FALSE;
+    st->tail = 0;
+    st->finished = RT_FALSE;
+    st->skip_frac = 0;
+    st->mid_valid = RT_FALSE;
+    st->out_pos = 0;
+    st->out_bytes = 0;
+}
+
+static rt_err_t stretch_open(struct wavsource *source, struct wavsource_format *format)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+    rt_size_t frame;
+    rt_err_t result;
+
+    result = st->source->ops->open(st->source, format);
+    if (result != RT_EOK)
+        return result;
+
+    st->format = *format;
+    st->bypass = format->samplebits != 16 || format->encoding != WAVSOURCE_ENCODING_PCM ||
+                 format->channels == 0 || format->samplerate < 1000;
+    if (st->bypass)
+    {
+        LOG_W("%d bits stream is played without stretch", format->samplebits);
+        return RT_EOK;
+    }
+
+    st->channels = format->channels;
+    st->frame_bytes = st->channels * sizeof(rt_int16_t);
+    st->sequence = format->samplerate * STRETCH_SEQUENCE_MS / 1000;
+    st->overlap = format->samplerate * STRETCH_OVERLAP_MS / 1000;
+    st->seek = format->samplerate * STRETCH_SEEK_MS / 1000;
+    st->in_capacity = (st->seek + st->sequence + 2 * (st->sequence - st->overlap)) * st->frame_bytes;
+
+    frame = st->frame_bytes;
+    st->in = rt_malloc(st->in_capacity);
+    st->mid = rt_malloc(st->overlap * frame);
+    st->out = rt_malloc((st->sequence - st->overlap) * frame);
+    st->mix_mid = rt_malloc(st->overlap * sizeof(rt_int16_t));
+    st->mix_in = rt_malloc((st->seek + st->overlap) * sizeof(rt_int16_t));
+    if (st->in == RT_NULL || st->mid == RT_NULL || st->out == RT_NULL ||
+        st->mix_mid == RT_NULL || st->mix_in == RT_NULL)
+    {
+        LOG_E("malloc stretch buffers failed");
+        stretch_free(st);
+        st->source->ops->close(st->source);
+        return -RT_ENOMEM;
+    }
+
+    stretch_restart(st);
+    st->read_pos = 0;
+    st->pos = 0;
+
+    return RT_EOK;
+}
+
+static rt_ssize_t stretch_read(struct wavsource *source, void *buffer, rt_size_t size, void **data)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+    rt_size_t length = 0, chunk;
+
+    if (st->bypass)
+        return st->source->ops->read(st->source, buffer, size, data);
+
+    *data = buffer;
+    while (length < size)
+    {
+        if (st->out_pos == st->out_bytes)
+        {
+            if (st->finished || !stretch_fill(st))
+                break;
+            stretch_segment(st);
+        }
+
+        chunk = st->out_bytes - st->out_pos;
+        if (chunk > size - length)
+            chunk = size - length;
+        rt_memcpy((rt_uint8_t *)buffer + length, (rt_uint8_t *)st->out + st->out_pos, chunk);
+        st->out_pos += chunk;
+        length += chunk;
+    }
+    st->pos += length;
+
+    return length;
+}
+
+static void stretch_release(struct wavsource *source, void *data, rt_size_t size)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+
+    /* stretched data was copied out of the source when it was read */
+    if (st->bypass && st->source->ops->release)
+        st->source->ops->release(st->source, data, size);
+}
+
+static rt_err_t stretch_seek(struct wavsource *source, rt_off_t offset)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+    rt_err_t result;
+
+    if (st->source->ops->seek == RT_NULL)
+        return -RT_ENOSYS;
+
+    result = st->source->ops->seek(st->source, offset);
+    if (result == RT_EOK && !st->bypass)
+    {
+        stretch_restart(st);
+        st->read_pos = offset;
+        st->pos = offset;
+    }
+
+    return result;
+}
+
+/* the bytes read so far and the source left, at the current speed */
+static rt_ssize_t stretch_length(struct wavsource *source)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+    rt_ssize_t length;
+    rt_int64_t frames;
+
+    if (st->source->ops->length == RT_NULL)
+        return -1;
+
+    length = st->source->ops->length(st->source);
+    if (st->bypass || length < 0)
+        return length;
+
+    /* frames not stretched yet, unread ones and the look-ahead */
+    if (st->finished)
+        frames = 0;
+    else if (st->eof)
+        frames = st->tail;
+    else
+        frames = ((rt_int64_t)length - st->read_pos + st->in_bytes) / st->frame_bytes;
+    if (frames < 0)
+        frames = 0;
+    frames = (frames << 16) / st->speed;
+
+    return (rt_ssize_t)(st->pos + (st->out_bytes - st->out_pos) + frames * st->frame_bytes);
+}
+
+static void stretch_close(struct wavsource *source)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+
+    st->source->ops->close(st->source);
+    stretch_free(st);
+}
+
+static void stretch_destroy(struct wavsource *source)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+
+    stretch_free(st);
+    wavsource_delete(st->source);
+    rt_free(st);
+}
+
+static const struct wavsource_ops stretch_ops =
+{
+    stretch_open,
+    stretch_read,
+    stretch_release,
+    stretch_seek,
+    stretch_close,
+    stretch_destroy,
+    stretch_length,
+};
+
+struct wavsource *wavsource_stretch_create(struct wavsource *source, float speed)
+{
+    struct wavsource_stretch *st;
+    rt_uint32_t value;
+
+    value = stretch_speed(speed);
+    if (source == RT_NULL || value == 0)
+        return RT_NULL;
+
+    st = rt_malloc(sizeof(struct wavsource_stretch));
+    if (st == RT_NULL)
+        return RT_NULL;
+    rt_memset(st, 0, sizeof(struct wavsource_stretch));
+
+    st->source = source;
+    st->speed = value;
+    st->parent.ops = &stretch_ops;
+    st->parent.name = source->name;
+
+    return &st->parent;
+}
+
+rt_err_t wavsource_stretch_set(struct wavsource *source, float speed)
+{
+    struct wavsource_stretch *st = (struct wavsource_stretch *)source;
+    rt_uint32_t value;
+
+    value = stretch_speed(speed);
+    if (source == RT_NULL || source->ops != &stretch_ops || value == 0)
+        return -RT_EINVAL;
+
+    st->speed = value;
+
+    return RT_EOK;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavtrace.h>
+
+#include <stdio.h>
+
+#define DBG_TAG              "WAV_TRACE"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+#define TRACE_THREADS_MAX    (16)
+
+/* slots are claimed without a lock, every writer gets its own */
+#if defined(__GNUC__)
+#define TRACE_CLAIM(head)    __sync_fetch_and_add(head, 1)
+#define TRACE_BARRIER()      __sync_synchronize()
+#else
+static rt_uint32_t trace_claim(volatile rt_uint32_t *head)
+{
+    rt_base_t level = rt_hw_interrupt_disable();
+    rt_uint32_t index = (*head)++;
+
+    rt_hw_interrupt_enable(level);
+
+    return index;
+}
+#define TRACE_CLAIM(head)    trace_claim(head)
+#define TRACE_BARRIER()
+#endif
+
+/* an entry is valid for the index whose sequence it holds, the sequence is written last */
+struct trace_slot
+{
+    volatile rt_uint32_t seq;               /* index + 1, 0 while the entry is written */
+    struct wavtrace_entry entry;
+};
+
+static struct trace_slot trace_ring[PKG_WP_TRACE_SIZE];
+static volatile rt_uint32_t trace_head;     /* events recorded, indices keep running across clears */
+static volatile rt_uint32_t trace_base;     /* head at the last clear */
+static volatile rt_bool_t trace_enabled;
+
+static const char *event_name[WAVTRACE_EVENT_MAX] =
+{
+    "start",
+    "stop",
+    "pause",
+    "resume",
+    "open",
+    "read",
+    "process",
+    "write",
+    "eos",
+    "capture",
+    "save",
+};
+
+/* Chrome trace phases of WAVTRACE_PHASE_xxx */
+static const char trace_phase[] = { 'B', 'E', 'i' };
+
+static rt_uint32_t trace_clock_us(void)
+{
+#ifdef RT_USING_CPUTIME
+    return (rt_uint32_t)clock_cpu_microsecond(clock_cpu_gettime());
+#else
+    return (rt_uint32_t)((rt_uint64_t)rt_tick_get() * 1000000 / RT_TICK_PER_SECOND);
+#endif
+}
+
+void wavtrace_record(int event, int phase, rt_uint32_t arg)
+{
+    struct trace_slot *slot;
+    struct wavtrace_entry *entry;
+    rt_uint32_t index;
+    rt_thread_t thread;
+
+    if (!trace_enabled)
+        return;
+
+    index = TRACE_CLAIM(&trace_head);
+    slot = &trace_ring[index % PKG_WP_TRACE_SIZE];
+    slot->seq = 0;
+    TRACE_BARRIER();
+
+    entry = &slot->entry;
+    entry->time = trace_clock_us();
+    entry->arg = arg;
+    entry->event = event;
+    entry->phase = phase;
+
+    thread = rt_thread_self();
+    if (thread)
+        rt_strncpy(entry->thread, ((struct rt_object *)thread)->name, RT_NAME_MAX);
+    else
+        rt_strncpy(entry->thread, "-", RT_NAME_MAX);
+
+    TRACE_BARRIER();
+    slot->seq = index + 1;
+}
+
+void wavtrace_enable(rt_bool_t enable)
+{
+    trace_enabled = enable;
+}
+
+void wavtrace_clear(void)
+{
+    rt_bool_t enabled = trace_enabled;
+
+    trace_enabled = RT_FALSE;
+    TRACE_BARRIER();
+    trace_base = trace_head;
+    TRACE_BARRIER();
+    trace_enabled = enabled;
+}
+
+rt_size_t wavtrace_read(struct wavtrace_entry *entries, rt_size_t count)
+{
+    rt_bool_t enabled = trace_enabled;
+    rt_uint32_t head, index, seq;
+    struct trace_slot *slot;
+    rt_size_t copied = 0;
+
+    trace_enabled = RT_FALSE;
+    TRACE_BARRIER();
+
+    head = trace_head;
+    if (count > head - trace_base)
+        count = head - trace_base;
+    if (count > PKG_WP_TRACE_SIZE)
+        count = PKG_WP_TRACE_SIZE;
+
+    /* the newest count events, a slot claimed but not written yet or rewritten meanwhile is skipped */
+    for (index = head - count; index != head; index++)
+    {
+        slot = &trace_ring[index % PKG_WP_TRACE_SIZE];
+        seq = slot->seq;
+        TRACE_BARRIER();
+        entries[copied] = slot->entry;
+        TRACE_BARRIER();
+        if (seq == index + 1 && slot->seq == seq)
+            copied++;
+    }
+
+    TRACE_BARRIER();
+    trace_enabled = enabled;
+
+    return copied;
+}
+
+const char *wavtrace_event_name(int event)
+{
+    if (event < 0 || event >= WAVTRACE_EVENT_MAX)
+        return "unknown";
+
+    return event_name[event];
+}
+
+static void trace_write(FILE *fp, const char *line)
+{
+    if (fp)
+        fputs(line, fp);
+    else
+        rt_kprintf("%s", line);
+}
+
+/* threads are numbered in the order they first show up, each gets a name record */
+static int trace_thread_id(char (*threads)[RT_NAME_MAX], int *count, const char *name)
+{
+    int i;
+
+    for (i = 0; i < *count; i++)
+    {
+        if (rt_strncmp(threads[i], name, RT_NAME_MAX) == 0)
+            return i + 1;
+    }
+
+    if (*count == TRACE_THREADS_MAX)
+        return 0;
+    rt_strncpy(threads[*count], name, RT_NAME_MAX);
+
+    return ++(*count);
+}
+
+rt_err_t wavtrace_export(const char *path)
+{
+    char threads[TRACE_THREADS_MAX][RT_NAME_MAX];
+    char line[128], name[RT_NAME_MAX + 1];
+    struct wavtrace_entry *entries;
+    rt_size_t count, i;
+    rt_uint32_t base;
+    FILE *fp = RT_NULL;
+    int tid, thread_count = 0;
+
+    entries = rt_malloc(PKG_WP_TRACE_SIZE * sizeof(struct wavtrace_entry));
+    if (entries == RT_NULL)
+        return -RT_ENOMEM;
+
+    if (path)
+    {
+        fp = fopen(path, "w");
+        if (fp == RT_NULL)
+        {
+            LOG_E("open %s failed", path);
+            rt_free(entries);
+            return -RT_ERROR;
+        }
+    }
+
+    count = wavtrace_read(entries, PKG_WP_TRACE_SIZE);
+
+    /* times are relative to the earliest event, threads may store theirs slightly out of order */
+    base = count ? entries[0].time : 0;
+    for (i = 1; i < count; i++)
+    {
+        if ((rt_int32_t)(entries[i].time - base) < 0)
+            base = entries[i].time;
+    }
+
+    trace_write(fp, "{\"traceEvents\":[\n");
+    for (i = 0; i < count; i++)
+    {
+        tid = trace_thread_id(threads, &thread_count, entries[i].thread);
+
+        rt_snprintf(line, sizeof(line),
+                    "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%u,\"pid\":1,\"tid\":%d,%s\"args\":{\"arg\":%u}},\n",
+                    wavtrace_event_name(entries[i].event), trace_phase[entries[i].phase % 3],
+                    entries[i].time - base, tid,
+                    entries[i].phase == WAVTRACE_PHASE_INSTANT ? "\"s\":\"t\"," : "", entries[i].arg);
+        trace_write(fp, line);
+    }
+
+    for (i = 0; i < thread_count; i++)
+    {
+        rt_memcpy(name, threads[i], RT_NAME_MAX);
+        name[RT_NAME_MAX] = '\0';
+        rt_snprintf(line, sizeof(line),
+                    "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+                    (int)i + 1, name);
+        trace_write(fp, line);
+    }
+    trace_write(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"wavplayer\"}}\n]}\n");
+
+    if (fp)
+        fclose(fp);
+    rt_free(entries);
+
+    return RT_EOK;
+}
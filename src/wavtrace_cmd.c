@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavtrace.h>
+
+#include <string.h>
+
+static void usage(void)
+{
+    rt_kprintf("usage: wavtrace <command>\n\n");
+    rt_kprintf("commands:\n");
+    rt_kprintf("  on          Record events of the player and the recorder.\n");
+    rt_kprintf("  off         Stop recording, the events are kept.\n");
+    rt_kprintf("  clear       Drop the recorded events.\n");
+    rt_kprintf("  dump [file] Print the last %d events as Chrome trace JSON, or write them to a file.\n",
+               PKG_WP_TRACE_SIZE);
+}
+
+int wav_trace(int argc, char *argv[])
+{
+    rt_err_t result;
+
+    if (argc == 2 && strcmp(argv[1], "on") == 0)
+    {
+        wavtrace_enable(RT_TRUE);
+        return RT_EOK;
+    }
+
+    if (argc == 2 && strcmp(argv[1], "off") == 0)
+    {
+        wavtrace_enable(RT_FALSE);
+        return RT_EOK;
+    }
+
+    if (argc == 2 && strcmp(argv[1], "clear") == 0)
+    {
+        wavtrace_clear();
+        return RT_EOK;
+    }
+
+    if ((argc == 2 || argc == 3) && strcmp(argv[1], "dump") == 0)
+    {
+        result = wavtrace_export(argc == 3 ? argv[2] : RT_NULL);
+        if (result != RT_EOK)
+            rt_kprintf("dump trace failed %d\n", result);
+        return result;
+    }
+
+    usage();
+
+    return -RT_ERROR;
+}
+
+MSH_CMD_EXPORT_ALIAS(wav_trace, wavtrace, trace timing of wavplayer and wavrecorder events);
@@ -0,0 +1,691 @@
+/*
+ * Copyright (c) 2006-2022, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Date           Author       Notes
+ * 2026-10-19     RT-Thread    first implementation
+ */
+
+#include <rtthread.h>
+#include <wavsource.h>
+#include <wavpcm.h>
+
+#include <math.h>
+
+#define DBG_TAG              "WAV_XFADE"
+#define DBG_LVL              DBG_INFO
+#include <rtdbg.h>
+
+#define XFADE_CHUNK          (256)          /* source frames converted at a time */
+#define XFADE_UNITY          (0x10000)      /* resampler step 1.0 in Q16 */
+#define XFADE_CURVE          (64)           /* segments of the quarter sine */
+
+/* a track converted to the bus format, 16 bits at the channels and rate of the first track */
+struct xfade_track
+{
+    struct wavsource *source;
+    struct wavsource_format format;
+    rt_size_t frame_bytes;                  /* of the source */
+    rt_bool_t convert;                      /* format differs from the bus */
+    struct wavpcm_dither dither;
+
+    rt_uint8_t *raw;                        /* chunk read from the source */
+    rt_int16_t *pcm;                        /* chunk in bus channels at the source rate */
+    rt_size_t pcm_frames;
+    rt_uint32_t step;                       /* source frames per bus frame, Q16 */
+    rt_int64_t phase;                       /* position in pcm, Q16, -1 frame is prev */
+    rt_int16_t prev[PKG_WP_DITHER_CHANNELS_MAX];
+
+    rt_ssize_t length;                      /* bytes of pcm of the source, < 0 when unknown */
+    rt_off_t pos;                           /* bytes read from the source */
+    rt_bool_t ended;
+};
+
+/*
+ * Plays a sequence of tracks. A queued track is opened and its first chunk
+ * read by the caller, the equal power crossfade starts when the current track
+ * is within the fade time of its end, or at once for a track that replaces it.
+ */
+struct wavsource_xfade
+{
+    struct wavsource parent;
+    char name[PKG_WP_URI_MAX];              /* name of the current track, its source is deleted after it */
+    rt_mutex_t lock;
+    struct wavsource *first;
+    struct wavsource_format bus;
+    rt_size_t bus_bytes;
+    rt_uint16_t time;                       /* ms */
+    rt_size_t fade_frames;
+    rt_int16_t curve[XFADE_CURVE + 1];      /* sin(0 ~ pi / 2), Q15 */
+
+    struct xfade_track *cur;
+    struct xfade_track *next;               /* opened and prefetched */
+    struct xfade_track *pending;            /* queued while fading into next */
+    rt_bool_t next_now;
+    rt_bool_t pending_now;
+    rt_bool_t fading;
+    rt_size_t fade_len;
+    rt_size_t fade_pos;
+    rt_bool_t finished;                     /* the stream ended or was closed */
+    rt_off_t pos;                           /* bytes returned by read, or the offset seeked to */
+
+    rt_int16_t *mix;                        /* next track during the fade */
+    rt_size_t mix_frames;
+};
+
+static rt_bool_t xfade_format_check(const struct wavsource_format *format)
+{
+    if (format->channels == 0 || format->channels > PKG_WP_DITHER_CHANNELS_MAX || format->samplerate == 0)
+        return RT_FALSE;
+
+    if (format->encoding == WAVSOURCE_ENCODING_FLOAT)
+        return format->samplebits == 32;
+
+    return format->samplebits == 8 || format->samplebits == 16 ||
+           format->samplebits == 24 || format->samplebits == 32;
+}
+
+static void xfade_track_free(struct xfade_track *track, rt_bool_t close)
+{
+    if (track == RT_NULL)
+        return;
+
+    if (close)
+        track->source->ops->close(track->source);
+    if (track->source->autodelete)
+        wavsource_delete(track->source);
+    if (track->raw)
+        rt_free(track->raw);
+    if (track->pcm)
+        rt_free(track->pcm);
+    rt_free(track);
+}
+
+/* the source is opened by the caller, it isn't released when this fails */
+static struct xfade_track *xfade_track_create(struct wavsource_xfade *xf, struct wavsource *source,
+                                              const struct wavsource_format *format)
+{
+    struct xfade_track *track;
+    rt_size_t bytes;
+
+    if (!xfade_format_check(format))
+    {
+        LOG_E("%s, %d bits %d channels can't be crossfaded", source->name, format->samplebits, format->channels);
+        return RT_NULL;
+    }
+
+    track = rt_malloc(sizeof(struct xfade_track));
+    if (track == RT_NULL)
+        return RT_NULL;
+    rt_memset(track, 0, sizeof(struct xfade_track));
+
+    track->source = source;
+    track->format = *format;
+    track->frame_bytes = format->channels * format->samplebits / 8;
+    track->convert = format->samplebits != 16 || format->encoding != WAVSOURCE_ENCODING_PCM ||
+                     format->channels != xf->bus.channels || format->samplerate != xf->bus.samplerate;
+    track->step = (rt_uint32_t)(((rt_uint64_t)format->samplerate << 16) / xf->bus.samplerate);
+    track->length = source->ops->length ? source->ops->length(source) : -1;
+    wavpcm_dither_init(&track->dither, WAVPCM_DITHER_TPDF);
+
+    /* 8 bits samples are widened in place */
+    bytes = format->samplebits == 8 ? format->channels * sizeof(rt_int16_t) : track->frame_bytes;
+    track->raw = rt_malloc(XFADE_CHUNK * bytes);
+    track->pcm = rt_malloc(XFADE_CHUNK * xf->bus_bytes);
+    if (track->raw == RT_NULL || track->pcm == RT_NULL)
+    {
+        if (track->raw)
+            rt_free(track->raw);
+        if (track->pcm)
+            rt_free(track->pcm);
+        rt_free(track);
+        return RT_NULL;
+    }
+
+    return track;
+}
+
+/* read a chunk of the source and convert it to 16 bits in bus channels */
+static rt_bool_t xfade_track_fill(struct wavsource_xfade *xf, struct xfade_track *track)
+{
+    int channels = track->format.channels, outputs = xf->bus.channels, c;
+    rt_int16_t *in, *out = track->pcm;
+    rt_size_t frames, i;
+    rt_ssize_t length;
+    rt_int32_t sum;
+    void *data;
+
+    track->pcm_frames = 0;
+    length = track->source->ops->read(track->source, track->raw, XFADE_CHUNK * track->frame_bytes, &data);
+    frames = length > 0 ? length / track->frame_bytes : 0;
+    if (frames == 0)
+    {
+        track->ended = RT_TRUE;
+        return RT_FALSE;
+    }
+    track->pos += length;
+
+    in = (rt_int16_t *)track->raw;
+    if (track->format.samplebits == 16 && track->format.encoding == WAVSOURCE_ENCODING_PCM)
+    {
+        in = data;
+    }
+    else if (track->format.samplebits == 8)
+    {
+        /* backwards, the wider samples overwrite bytes already converted */
+        for (i = frames * channels; i-- > 0;)
+            in[i] = (rt_int16_t)((((const rt_uint8_t *)data)[i] - 128) * 256);
+    }
+    else
+    {
+        wavpcm_requantize16(&track->dither, data, track->format.samplebits,
+                            track->format.encoding == WAVSOURCE_ENCODING_FLOAT, in, channels, frames);
+    }
+
+    if (channels == outputs)
+    {
+        rt_memcpy(out, in, frames * xf->bus_bytes);
+    }
+    else if (outputs == 1)
+    {
+        for (i = 0; i < frames; i++, in += channels)
+        {
+            for (c = 0, sum = 0; c < channels; c++)
+                sum += in[c];
+            out[i] = (rt_int16_t)(sum / channels);
+        }
+    }
+    else
+    {
+        /* mono goes to every channel, others to the same channel or nowhere */
+        for (i = 0; i < frames; i++, in += channels, out += outputs)
+        {
+            for (c = 0; c < outputs; c++)
+                out[c] = channels == 1 ? in[0] : (c < channels ? in[c] : 0);
+        }
+    }
+
+    if (track->source->ops->release)
+        track->source->ops->release(track->source, data, length);
+    track->pcm_frames = frames;
+
+    return RT_TRUE;
+}
+
+/* get up to frames of the bus format, returns the frames written to out */
+static rt_size_t xfade_track_read(struct wavsource_xfade *xf, struct xfade_track *track,
+                                  rt_int16_t *out, rt_size_t frames)
+{
+    int channels = xf->bus.channels, c;
+    rt_size_t done = 0, count;
+    rt_int32_t index, frac, a, b;
+    rt_ssize_t length;
+    void *data;
+
+    while (done < frames && !track->ended)
+    {
+        index = (rt_int32_t)(track->phase >> 16);
+
+        if (track->step == XFADE_UNITY)
+        {
+            if (index >= (rt_int32_t)track->pcm_frames)
+            {
+                if (!track->convert)
+                {
+                    /* same format as the bus, read straight into the output */
+                    length = track->source->ops->read(track->source, out + done * channels,
+                                                      (frames - done) * xf->bus_bytes, &data);
+                    if (length < (rt_ssize_t)xf->bus_bytes)
+                    {
+                        track->ended = RT_TRUE;
+                        break;
+                    }
+                    if (data != out + done * channels)
+                        rt_memcpy(out + done * channels, data, length);
+                    if (track->source->ops->release)
+                        track->source->ops->release(track->source, data, length);
+                    track->pos += length;
+                    done += length / xf->bus_bytes;
+                    continue;
+                }
+
+                track->phase -= (rt_int64_t)track->pcm_frames << 16;
+                xfade_track_fill(xf, track);
+                continue;
+            }
+
+            count = track->pcm_frames - index;
+            if (count > frames - done)
+                count = frames - done;
+            rt_memcpy(out + done * channels, track->pcm + index * channels, count * xf->bus_bytes);
+            track->phase += (rt_int64_t)count << 16;
+            done += count;
+        }
+        else
+        {
+            /* linear interpolation, the last frame of a chunk is kept for the next one */
+            if (index + 1 >= (rt_int32_t)track->pcm_frames)
+            {
+                if (track->pcm_frames > 0)
+                    rt_memcpy(track->prev, track->pcm + (track->pcm_frames - 1) * channels, xf->bus_bytes);
+                track->phase -= (rt_int64_t)track->pcm_frames << 16;
+                xfade_track_fill(xf, track);
+                continue;
+            }
+
+            frac = (rt_int32_t)(track->phase & 0xFFFF);
+            for (c = 0; c < channels; c++)
+            {
+                a = index < 0 ? track->prev[c] : track->pcm[index * channels + c];
+                b = track->pcm[(index + 1) * channels + c];
+                out[done * channels + c] = (rt_int16_t)(a + (((b - a) * frac) >> 16));
+            }
+            track->phase += track->step;
+            done++;
+        }
+    }
+
+    return done;
+}
+
+/* bus frames left in a track, < 0 when the length of the source is unknown */
+static rt_ssize_t xfade_track_remain(struct xfade_track *track)
+{
+    rt_int64_t frames;
+
+    /* asked again, a crossfade grows as tracks are queued on it */
+    if (track->source->ops->length)
+        track->length = track->source->ops->length(track->source);
+    if (track->length < 0)
+        return -1;
+
+    frames = (track->length - track->pos) / track->frame_bytes;
+    if (frames < 0)
+        frames = 0;
+    frames += track->pcm_frames - (track->phase >> 16);
+
+    return (rt_ssize_t)((frames << 16) / track->step);
+}
+
+/*
+ * frames left once a track of remain frames follows one that ends in end frames,
+ * its fade doesn't start before start
+ */
+static rt_ssize_t xfade_follow(struct wavsource_xfade *xf, rt_ssize_t start, rt_ssize_t end,
+                               rt_ssize_t remain, rt_bool_t now)
+{
+    rt_ssize_t fade = (rt_ssize_t)xf->fade_frames;
+
+    /* a replacing track cuts the one before it at the end of the fade */
+    if (now && end > start + fade)
+        end = start + fade;
+    else if (!now && end - fade > start)
+        start = end - fade;
+
+    return start + remain > end ? start + remain : end;
+}
+
+/* bus frames left in the stream, < 0 when the length of a track is unknown */
+static rt_ssize_t xfade_remain(struct wavsource_xfade *xf)
+{
+    rt_ssize_t cur, next, pending, end;
+
+    cur = xfade_track_remain(xf->cur);
+    if (cur < 0 || xf->next == RT_NULL)
+        return cur;
+
+    next = xfade_track_remain(xf->next);
+    if (next < 0)
+        return -1;
+    if (!xf->fading)
+        return xfade_follow(xf, 0, cur, next, xf->next_now);
+
+    /* the current track stops at the end of the fade, a pending one follows next from there */
+    end = (rt_ssize_t)(xf->fade_len - xf->fade_pos);
+    if (cur < end)
+        end = cur;
+    if (xf->pending == RT_NULL)
+        return next > end ? next : end;
+
+    pending = xfade_track_remain(xf->pending);
+    if (pending < 0)
+        return -1;
+
+    return xfade_follow(xf, end, next > end ? next : end, pending, xf->pending_now);
+}
+
+static void xfade_switch(struct wavsource_xfade *xf)
+{
+    struct xfade_track *old = xf->cur;
+
+    xf->cur = xf->next;
+    xf->next = xf->pending;
+    xf->next_now = xf->pending_now;
+    xf->pending = RT_NULL;
+    xf->fading = RT_FALSE;
+    rt_strncpy(xf->name, xf->cur->source->name, sizeof(xf->name) - 1);
+
+    xfade_track_free(old, RT_TRUE);
+    LOG_D("crossfaded to %s", xf->parent.name);
+}
+
+static rt_int32_t xfade_gain(struct wavsource_xfade *xf, rt_uint32_t position)
+{
+    rt_uint32_t index = position >> 16, frac = position & 0xFFFF;
+
+    if (index >= XFADE_CURVE)
+        return xf->curve[XFADE_CURVE];
+
+    return xf->curve[index] + (((xf->curve[index + 1] - xf->curve[index]) * (rt_int32_t)frac) >> 16);
+}
+
+static rt_err_t xfade_open(struct wavsource *source, struct wavsource_format *format)
+{
+    struct wavsource_xfade *xf = (struct wavsource_xfade *)source;
+    struct wavsource_format input;
+    rt_err_t result;
+
+    /* the tracks are consumed as they are played, the sequence can't be opened again */
+    if (xf->first == RT_NULL)
+        return -RT_EBUSY;
+
+    result = xf->first->ops->open(xf->first, &input);
+    if (result != RT_EOK)
+        return result;
+
+    xf->bus.samplerate = input.samplerate;
+    xf->bus.channels = input.channels;
+    xf->bus.samplebits = 16;
+    xf->bus.encoding = WAVSOURCE_ENCODING_PCM;
+    xf->bus_bytes = input.channels * sizeof(rt_int16_t);
+    xf->fade_frames = input.samplerate * xf->time / 1000;
+    if (xf->fade_frames == 0)
+        xf->fade_frames = 1;
+
+    xf->cur = xfade_track_create(xf, xf->first, &input);
+    if (xf->cur == RT_NULL)
+    {
+        xf->first->ops->close(xf->first);
+        return -RT_ERROR;
+    }
+    /* the first track belongs to the crossfade from now on */
+    xf->first = RT_NULL;
+    xf->finished = RT_FALSE;
+    xf->pos = 0;
+    *format = xf->bus;
+
+    return RT_EOK;
+}
+
+static rt_ssize_t xfade_read(struct wavsource *source, void *buffer, rt_size_t size, void **data)
+{
+    struct wavsource_xfade *xf = (struct wavsource_xfade *)source;
+    rt_int16_t *out = buffer;
+    rt_size_t frames, a, b, count, i;
+    rt_uint32_t position, step;
+    rt_ssize_t remain;
+    rt_int32_t gain_in, gain_out, sample;
+    int channels = xf->bus.channels, c;
+
+    frames = size / xf->bus_bytes;
+    *data = buffer;
+
+    rt_mutex_take(xf->lock, RT_WAITING_FOREVER);
+
+    /* a replacing track fades in at once, a queued one over the tail of the current track */
+    if (!xf->fading && xf->next)
+    {
+        remain = xfade_track_remain(xf->cur);
+        if (xf->next_now || (remain >= 0 && (rt_size_t)remain <= xf->fade_frames))
+        {
+            if (xf->next_now)
+                xf->fade_len = xf->fade_frames;
+            else
+                xf->fade_len = remain > 0 ? remain : 1;
+            xf->fade_pos = 0;
+            xf->fading = RT_TRUE;
+        }
+    }
+
+    if (!xf->fading)
+    {
+        count = xfade_track_read(xf, xf->cur, out, frames);
+        /* the length was unknown, the next track follows without a gap */
+        if (count == 0 && xf->next)
+        {
+            xfade_switch(xf);
+            count = xfade_track_read(xf, xf->cur, out, frames);
+        }
+        if (count == 0)
+            xf->finished = RT_TRUE;
+        xf->pos += count * xf->bus_bytes;
+
+        rt_mutex_release(xf->lock);
+        return count * xf->bus_bytes;
+    }
+
+    if (frames > xf->mix_frames)
+    {
+        if (xf->mix)
+            rt_free(xf->mix);
+        xf->mix = rt_malloc(frames * xf->bus_bytes);
+        xf->mix_frames = xf->mix ? frames : 0;
+        if (xf->mix == RT_NULL)
+        {
+            rt_mutex_release(xf->lock);
+            return -RT_ENOMEM;
+        }
+    }
+
+    a = xfade_track_read(xf, xf->cur, out, frames);
+    b = xfade_track_read(xf, xf->next, xf->mix, frames);
+    rt_memset(out + a * channels, 0, (frames - a) * xf->bus_bytes);
+    rt_memset(xf->mix + b * channels, 0, (frames - b) * xf->bus_bytes);
+    count = a > b ? a : b;
+
+    /* equal power, the gain of the next track rises along a quarter sine as the current one falls */
+    step = (rt_uint32_t)(((rt_uint64_t)XFADE_CURVE << 16) / xf->fade_len);
+    position = (rt_uint32_t)(((rt_uint64_t)xf->fade_pos * (XFADE_CURVE << 16)) / xf->fade_len);
+    for (i = 0; i < count; i++, position += step)
+    {
+        gain_in = xfade_gain(xf, position);
+        gain_out = xfade_gain(xf, position < (XFADE_CURVE << 16) ? (XFADE_CURVE << 16) - position : 0);
+        for (c = 0; c < channels; c++)
+        {
+            sample = (out[i * channels + c] * gain_out + xf->mix[i * channels + c] * gain_in) >> 15;
+            out[i * channels + c] = sample > 32767 ? 32767 : (sample < -32768 ? -32768 : sample);
+        }
+    }
+
+    xf->fade_pos += count;
+    if (xf->fade_pos >= xf->fade_len || xf->cur->ended)
+        xfade_switch(xf);
+    if (count == 0)
+        xf->finished = RT_TRUE;
+    xf->pos += count * xf->bus_bytes;
+
+    rt_mutex_release(xf->lock);
+
+    return count * xf->bus_bytes;
+}
+
+static rt_err_t xfade_seek(struct wavsource *source, rt_off_t offset)
+{
+    struct wavsource_xfade *xf = (struct wavsource_xfade *)source;
+    struct xfade_track *track;
+    rt_err_t result = -RT_ENOSYS;
+
+    rt_mutex_take(xf->lock, RT_WAITING_FOREVER);
+
+    /* only the current track, while it is played as is */
+    track = xf->cur;
+    if (!xf->fading && !track->convert && track->source->ops->seek)
+    {
+        result = track->source->ops->seek(track->source, offset);
+        if (result == RT_EOK)
+        {
+            track->pos = offset;
+            track->pcm_frames = 0;
+            track->phase = 0;
+            track->ended = RT_FALSE;
+            xf->pos = offset;
+        }
+    }
+
+    rt_mutex_release(xf->lock);
+
+    return result;
+}
+
+/* the bytes read so far and the ones left, so a crossfade over this one knows where its tail is */
+static rt_ssize_t xfade_length(struct wavsource *source)
+{
+    struct wavsource_xfade *xf = (struct wavsource_xfade *)source;
+    rt_ssize_t remain = -1;
+
+    rt_mutex_take(xf->lock, RT_WAITING_FOREVER);
+    if (xf->cur && !xf->finished)
+        remain = xfade_remain(xf);
+    if (remain >= 0)
+        remain = (rt_ssize_t)xf->pos + remain * (rt_ssize_t)xf->bus_bytes;
+    rt_mutex_release(xf->lock);
+
+    return remain;
+}
+
+static void xfade_close(struct wavsource *source)
+{
+    struct wavsource_xfade *xf = (struct wavsource_xfade *)source;
+
+    rt_mutex_take(xf->lock, RT_WAITING_FOREVER);
+    if (xf->cur)
+        xf->cur->source->ops->close(xf->cur->source);
+    xfade_track_free(xf->next, RT_TRUE);
+    xfade_track_free(xf->pending, RT_TRUE);
+    xf->next = RT_NULL;
+    xf->pending = RT_NULL;
+    xf->fading = RT_FALSE;
+    xf->finished = RT_TRUE;
+    rt_mutex_release(xf->lock);
+}
+
+static void xfade_destroy(struct wavsource *source)
+{
+    struct wavsource_xfade *xf = (struct wavsource_xfade *)source;
+
+    /* closed already, or never opened */
+    xfade_track_free(xf->next, RT_TRUE);
+    xfade_track_free(xf->pending, RT_TRUE);
+    xfade_track_free(xf->cur, RT_FALSE);
+    if (xf->first && xf->first->autodelete)
+        wavsource_delete(xf->first);
+    if (xf->mix)
+        rt_free(xf->mix);
+    rt_mutex_delete(xf->lock);
+    rt_free(xf);
+}
+
+static const struct wavsource_ops xfade_ops =
+{
+    xfade_open,
+    xfade_read,
+    RT_NULL,
+    xfade_seek,
+    xfade_close,
+    xfade_destroy,
+    xfade_length,
+};
+
+struct wavsource *wavsource_xfade_create(struct wavsource *source, rt_uint16_t time)
+{
+    struct wavsource_xfade *xf;
+    int i;
+
+    if (source == RT_NULL || time == 0)
+        return RT_NULL;
+
+    xf = rt_malloc(sizeof(struct wavsource_xfade));
+    if (xf == RT_NULL)
+        return RT_NULL;
+    rt_memset(xf, 0, sizeof(struct wavsource_xfade));
+
+    xf->lock = rt_mutex_create("wp_xfade", RT_IPC_FLAG_PRIO);
+    if (xf->lock == RT_NULL)
+    {
+        rt_free(xf);
+        return RT_NULL;
+    }
+
+    for (i = 0; i <= XFADE_CURVE; i++)
+        xf->curve[i] = (rt_int16_t)(32767.0f * sinf(1.5707963f * i / XFADE_CURVE));
+
+    xf->first = source;
+    xf->time = time;
+    xf->parent.ops = &xfade_ops;
+    rt_strncpy(xf->name, source->name, sizeof(xf->name) - 1);
+    xf->parent.name = xf->name;
+
+    return &xf->parent;
+}
+
+rt_err_t wavsource_xfade_next(struct wavsource *source, struct wavsource *next, rt_bool_t now)
+{
+    struct wavsource_xfade *xf = (struct wavsource_xfade *)source;
+    struct wavsource_format format;
+    struct xfade_track *track, *old = RT_NULL;
+    rt_err_t result;
+
+    if (source == RT_NULL || source->ops != &xfade_ops || next == RT_NULL)
+        return -RT_EINVAL;
+
+    /* the bus format is known once the stream is opened */
+    if (xf->cur == RT_NULL || xf->finished)
+        return -RT_ERROR;
+
+    result = next->ops->open(next, &format);
+    if (result != RT_EOK)
+        return result;
+
+    /* opened and prefetched here, the reader thread only has to read on */
+    track = xfade_track_create(xf, next, &format);
+    if (track == RT_NULL)
+    {
+        next->ops->close(next);
+        return -RT_ERROR;
+    }
+    xfade_track_fill(xf, track);
+
+    rt_mutex_take(xf->lock, RT_WAITING_FOREVER);
+    if (xf->finished)
+    {
+        result = -RT_ERROR;
+    }
+    else if (xf->fading)
+    {
+        old = xf->pending;
+        xf->pending = track;
+        xf->pending_now = now;
+    }
+    else
+    {
+        old = xf->next;
+        xf->next = track;
+        xf->next_now = now;
+    }
+    rt_mutex_release(xf->lock);
+
+    if (result != RT_EOK)
+    {
+        /* left to the caller */
+        next->ops->close(next);
+        track->source = RT_NULL;
+        rt_free(track->raw);
+        rt_free(track->pcm);
+        rt_free(track);
+        return result;
+    }
+    xfade_track_free(old, RT_TRUE);
+
+    return RT_EOK;
+}